@@ -0,0 +1,254 @@
+/*
+ * consistency-check.cpp
+ *
+ *  created on: 19.10.2026
+ */
+
+/*
+ * Checks that the alternative solvers of Agnes agree with the sequential explicit one on an instance of the examples:
+ *  - the parallel attractor (Monitor::no_threads_>1) against the sequential attractor, on the games of the first round of both components,
+ *  - the concurrent iterative deepening (parallel_iterative_deepening_search) against iterative_deepening_search,
+ *  - the games solved with several threads inside each round (Negotiate::solver_threads_) against a single thread,
+ *  - the symbolic engine (use_symbolic_engine) against the explicit games,
+ *  - the monitors with memory-mapped transitions (use_out_of_core_monitors) against the monitors in memory.
+ * The outcomes are compared exactly: the sure and maybe winning strategies and the spoilers of the games, and the depth and the languages of the guarantees of the searches.
+ * In addition, the peak resident memory of building, trimming and writing out a memory-mapped monitor (the product of each component with the guarantees found by the search) is checked against the memory budget, plus 16 bytes per monitor state for the maps of the states, and 8 MiB for the write buffers and for the pages which the kernel maps around the ones read.
+ *
+ * Usage (from the folder of an instance created by mutex-generate or factory-generate):
+ *      ./consistency-check [k_max] [no_threads] [memory_budget] [dir]
+ * where memory_budget (in bytes, 4 MiB by default) and dir (/tmp by default) are the memory budget and the directory of the memory-mapped monitors.
+ * The program prints one line per check and returns 0 if all the checks pass, and 1 otherwise.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <functional>
+#include <unordered_set>
+#include <bits/stdc++.h> /* for setting max_depth_=highest possible integer by default */
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "Component.hpp"
+#include "SafetyAutomaton.hpp"
+#include "Monitor.hpp"
+#include "SafetyGame.hpp"
+#include "LivenessGame.hpp"
+#include "Spoilers.hpp"
+#include "Negotiate.hpp"
+
+using namespace std;
+using namespace negotiation;
+
+/* the input files of the instance: the mutex instances name the components pr_0 and pr_1, the factory instances feeder and plant */
+void input_files(std::vector<std::string*>& component_files, std::vector<std::string*>& safe_states_files, std::vector<std::string*>& target_states_files) {
+    std::vector<std::string> names{"pr_0","pr_1"}, spec_names{"0","1"};
+    if (!std::ifstream("Inputs/pr_0.txt").good()) {
+        names={"feeder","plant"};
+        spec_names=names;
+    }
+    for (int c=0; c<2; c++) {
+        component_files.push_back(new std::string("Inputs/"+names[c]+".txt"));
+        safe_states_files.push_back(new std::string("Inputs/safe_states_"+spec_names[c]+".txt"));
+        target_states_files.push_back(new std::string("Inputs/target_states_"+spec_names[c]+".txt"));
+    }
+}
+
+/* the sets of a strategy as sorted vectors */
+std::vector<std::vector<abs_type>> sorted_sets(const std::vector<arena_set*>& D) {
+    std::vector<std::vector<abs_type>> v(D.size());
+    for (size_t i=0; i<D.size(); i++) {
+        v[i].assign(D[i]->begin(),D[i]->end());
+        std::sort(v[i].begin(),v[i].end());
+    }
+    return v;
+}
+
+/* an encoding of the language of a safety automaton: the canonical encoding of its minimal deterministic automaton */
+std::vector<abs_type> language(const SafetyAutomaton& A) {
+    SafetyAutomaton B(A);
+    return SafetyAutomaton(B.no_inputs_).determinizedProduct(B).canonicalEncoding();
+}
+
+/* the outcome of the games of the first round of a component */
+struct GameOutcome {
+    std::vector<std::vector<abs_type>> sure_safe_, maybe_safe_;
+    int flag_safety_, flag_liveness_;
+    std::vector<abs_type> spoilers_safety_, spoilers_liveness_;
+    bool operator==(const GameOutcome& other) const {
+        return (sure_safe_==other.sure_safe_ && maybe_safe_==other.maybe_safe_ &&
+                flag_safety_==other.flag_safety_ && flag_liveness_==other.flag_liveness_ &&
+                spoilers_safety_==other.spoilers_safety_ && spoilers_liveness_==other.spoilers_liveness_);
+    }
+};
+
+/* solve the games of the first round of component c (where the assumption and the guarantee accept everything), in the same way as Negotiate::solve_spoilers_overall */
+GameOutcome solve_first_round(Negotiate& N, const int c, const int no_threads) {
+    Component& comp=*N.components_[c];
+    SafetyAutomaton assume(comp.no_dist_inputs), guarantee(comp.no_outputs);
+    SafetyGame monitor(comp,assume,guarantee);
+    monitor.no_threads_=no_threads;
+    /* expand every frontier with all the threads, so that the small models exercise the concurrent mode as well */
+    monitor.min_parallel_frontier_=1;
+    GameOutcome out;
+    std::vector<arena_set*> sure_safe=monitor.solve_safety_game(*N.safe_states_[c],"sure",true);
+    std::vector<arena_set*> maybe_safe=monitor.solve_safety_game(*N.safe_states_[c],"maybe",true);
+    out.sure_safe_=sorted_sets(sure_safe);
+    out.maybe_safe_=sorted_sets(maybe_safe);
+    SafetyAutomaton spoilers_safety;
+    out.flag_safety_=monitor.find_spoilers(sure_safe,maybe_safe,&spoilers_safety);
+    out.spoilers_safety_=language(spoilers_safety);
+    out.flag_liveness_=-1;
+    if (out.flag_safety_==0) {
+        return out;
+    }
+    std::vector<arena_set*> allowed_joint_inputs;
+    for (abs_type i=0; i<monitor.no_states; i++) {
+        if (out.flag_safety_==2) {
+            arena_set* s=monitor.new_set();
+            for (auto l=sure_safe[i]->begin(); l!=sure_safe[i]->end(); ++l) {
+                for (abs_type k=0; k<monitor.no_dist_inputs; k++) {
+                    s->insert(monitor.addr_uw(*l,k));
+                }
+            }
+            allowed_joint_inputs.push_back(s);
+        } else {
+            allowed_joint_inputs.push_back(monitor.new_set(*maybe_safe[i]));
+        }
+    }
+    LivenessGame monitor_live(monitor,*N.target_states_[c],sure_safe,allowed_joint_inputs);
+    SafetyAutomaton spoilers_liveness;
+    out.flag_liveness_=monitor_live.find_spoilers(&spoilers_liveness);
+    out.spoilers_liveness_=language(spoilers_liveness);
+    return out;
+}
+
+/* the outcome of a search: the guarantees are only compared when a solution was found */
+struct SearchOutcome {
+    int k_;
+    bool solved_;
+    std::vector<std::vector<abs_type>> guarantees_;
+    bool operator==(const SearchOutcome& other) const {
+        return (k_==other.k_ && solved_==other.solved_ && (!solved_ || guarantees_==other.guarantees_));
+    }
+};
+
+/* run a search on a fresh negotiation object, after configuring it (the guarantees found are copied to guarantees, if given) */
+SearchOutcome search(const int k_max, const std::function<void(Negotiate&)>& configure, const std::function<int(Negotiate&)>& run, std::vector<SafetyAutomaton>* guarantees=nullptr) {
+    std::vector<std::string*> component_files, safe_states_files, target_states_files;
+    input_files(component_files,safe_states_files,target_states_files);
+    Negotiate N(component_files,safe_states_files,target_states_files,k_max);
+    configure(N);
+    SearchOutcome out;
+    out.k_=run(N);
+    out.solved_=(out.k_>=0 && out.k_<=k_max);
+    for (size_t c=0; c<N.guarantee_.size(); c++) {
+        out.guarantees_.push_back(language(*N.guarantee_[c]));
+        if (guarantees) {
+            guarantees->push_back(*N.guarantee_[c]);
+        }
+    }
+    return out;
+}
+
+/* the resident memory of the process, in bytes */
+size_t resident_memory() {
+    long pages=0, resident=0;
+    std::ifstream statm("/proc/self/statm");
+    statm >> pages >> resident;
+    return size_t(resident)*sysconf(_SC_PAGESIZE);
+}
+
+/* build a monitor with memory-mapped transitions, trim it and write it out in a child process, and check that the peak resident memory of the child grows by at most memory_budget plus the allowance described above (the peak of a child process starts from its resident memory when it is forked) */
+bool mapped_monitor_fits(Component& comp, SafetyAutomaton& assume, SafetyAutomaton& guarantee, const std::string& dir, const size_t memory_budget) {
+    pid_t pid=fork();
+    if (pid<0) {
+        return false;
+    }
+    if (pid==0) {
+        bool fits=false;
+        try {
+            size_t start=resident_memory();
+            Monitor monitor(comp,assume,guarantee,dir,memory_budget);
+            size_t no_states=monitor.no_states;
+            std::string filename=dir+"/consistency-check-monitor.txt";
+            monitor.trim();
+            monitor.writeToFile(filename);
+            std::remove(filename.c_str());
+            struct rusage usage;
+            getrusage(RUSAGE_SELF,&usage);
+            size_t peak=size_t(usage.ru_maxrss)*1024;
+            size_t bound=memory_budget+16*no_states+(size_t(8)<<20);
+            std::cerr << "\tmonitor with " << no_states << " states: peak resident memory grew by " << (peak>start ? peak-start : 0) << " bytes (bound " << bound << ")\n";
+            fits=(peak<=start+bound);
+        } catch (std::exception& e) {
+            std::cerr << "\t" << e.what() << "\n";
+        }
+        std::cerr.flush();
+        _exit(fits ? 0 : 1);
+    }
+    int status=0;
+    waitpid(pid,&status,0);
+    return (WIFEXITED(status) && WEXITSTATUS(status)==0);
+}
+
+/****************************************************************************/
+/* main computation */
+/****************************************************************************/
+int main(int argc, char** argv) {
+    /* maximum depth of negotiation */
+    int k_max = (argc>1 ? atoi(argv[1]) : 25);
+    /* the number of threads of the parallel variants */
+    int no_threads = (argc>2 ? atoi(argv[2]) : 4);
+    /* the memory budget and the directory of the memory-mapped monitors */
+    size_t memory_budget = (argc>3 ? std::stoull(argv[3]) : size_t(4)<<20);
+    std::string dir = (argc>4 ? argv[4] : "/tmp");
+    int failures=0;
+    auto report = [&](const std::string& check, const bool passed) {
+        std::cerr << (passed ? "PASS " : "FAIL ") << check << "\n";
+        if (!passed) {
+            failures++;
+        }
+    };
+    /* the progress messages of the searches go to std::cout, the results of the checks to std::cerr */
+    {
+        std::vector<std::string*> component_files, safe_states_files, target_states_files;
+        input_files(component_files,safe_states_files,target_states_files);
+        Negotiate N(component_files,safe_states_files,target_states_files,k_max);
+        for (int c=0; c<2; c++) {
+            report("parallel attractor, games of component "+std::to_string(c),solve_first_round(N,c,1)==solve_first_round(N,c,no_threads));
+        }
+    }
+    auto no_configuration = [](Negotiate&) {};
+    auto sequential = [](Negotiate& N) {
+        return N.iterative_deepening_search();
+    };
+    std::vector<SafetyAutomaton> guarantees;
+    SearchOutcome reference=search(k_max,no_configuration,sequential,&guarantees);
+    std::cerr << "reference: k = " << reference.k_ << "\n";
+    report("concurrent iterative deepening",search(k_max,no_configuration,[&](Negotiate& N) {
+        return N.parallel_iterative_deepening_search(0,no_threads);
+    })==reference);
+    report("parallel attractor, whole search",search(k_max,[&](Negotiate& N) {
+        N.solver_threads_=no_threads;
+    },sequential)==reference);
+    report("symbolic engine",search(k_max,[](Negotiate& N) {
+        /* in every round, also on the small monitors for which the symbolic games are skipped by default */
+        N.use_symbolic_engine(true,0);
+    },sequential)==reference);
+    report("memory-mapped monitors",search(k_max,[&](Negotiate& N) {
+        N.use_out_of_core_monitors(dir,memory_budget);
+    },sequential)==reference);
+    {
+        std::vector<std::string*> component_files, safe_states_files, target_states_files;
+        input_files(component_files,safe_states_files,target_states_files);
+        Negotiate N(component_files,safe_states_files,target_states_files,k_max);
+        for (int c=0; c<2; c++) {
+            report("peak resident memory of a memory-mapped monitor of component "+std::to_string(c),mapped_monitor_fits(*N.components_[c],guarantees[1-c],guarantees[c],dir,memory_budget));
+        }
+    }
+    return (failures==0 ? 0 : 1);
+}
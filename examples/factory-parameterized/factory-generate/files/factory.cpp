@@ -141,7 +141,7 @@ int main() {
     std::string current_working_dir(buff);
     /* get the parameters of this example (the substring following "factory_") */
     char substr[10]="factory_";
-    char params[20];
+    char params[FILENAME_MAX]="";
     for (int i=0; buff[i]!='\0'; i++) {
         int j=0;
         if (buff[i]==substr[j]) {
@@ -71,9 +71,30 @@ int main() {
         std::string file_ip="Inputs/pr_";
         file_ip+=std::to_string(p);
         file_ip+=".txt";
-        readVec<std::string>(file_ip, state_labels, (size_t)N.components_[p]->no_states, "STATE_LABELS");
+        /* the labels and the clusters are given for the states of the file, which were renumbered when the unreachable states were trimmed */
+        const std::vector<abs_type>& old_to_new=N.trimmed_state_map_[p];
+        abs_type no_states=N.components_[p]->no_states;
+        std::vector<std::string*> file_state_labels;
+        readVec<std::string>(file_ip, file_state_labels, old_to_new.size(), "STATE_LABELS");
+        state_labels.resize(no_states);
+        for (size_t i=0; i<file_state_labels.size(); i++) {
+            if (old_to_new[i]<no_states) {
+                state_labels[old_to_new[i]]=file_state_labels[i];
+            } else {
+                delete file_state_labels[i];
+            }
+        }
         readMember<abs_type>(file_ip, no_state_clusters, "NO_CLUSTERS");
         readVecSet<abs_type>(file_ip, state_clusters, no_state_clusters, "STATE_CLUSTERS");
+        for (size_t c=0; c<state_clusters.size(); c++) {
+            std::unordered_set<abs_type> cluster_old=*state_clusters[c];
+            state_clusters[c]->clear();
+            for (auto i=cluster_old.begin(); i!=cluster_old.end(); ++i) {
+                if (*i<old_to_new.size() && old_to_new[*i]<no_states) {
+                    state_clusters[c]->insert(old_to_new[*i]);
+                }
+            }
+        }
         std::vector<std::string*> control_input_labels, dist_input_labels;
         std::string* str=new std::string;
         *str="wr";
@@ -142,7 +163,7 @@ int main() {
     std::string current_working_dir(buff);
     /* get the parameters of this example (the substring following "mutex_") */
     char substr[10]="mutex_";
-    char params[20];
+    char params[FILENAME_MAX]="";
     for (int i=0; buff[i]!='\0'; i++) {
         int j=0;
         if (buff[i]==substr[j]) {
@@ -0,0 +1,150 @@
+/* Arena.hpp
+ *
+ *  Date: 19/10/2026 */
+
+/** @file **/
+#ifndef ARENA_HPP_
+#define ARENA_HPP_
+
+#include <vector>
+#include <unordered_set>
+#include <memory>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+/** @namespace negotiation **/
+namespace negotiation {
+
+/**
+ *  @class Arena
+ *
+ *  @brief A monotonic memory resource.
+ *
+ *  Memory is handed out from large blocks by bumping a pointer, individual deallocations are ignored, and everything is given back at once by release() (or by the destructor). The monitors and the games of one negotiation round allocate all their transition sets and strategies from one arena, so that the whole round is freed in one go when the arena goes out of scope.
+ *  An arena is not thread-safe; concurrent negotiations use separate arenas.
+ */
+class Arena {
+private:
+    /** @brief the allocated blocks **/
+    std::vector<char*> blocks_;
+    /** @brief the next free byte in the current block **/
+    char* cur_;
+    /** @brief the number of free bytes in the current block **/
+    size_t left_;
+    /** @brief the size of the next block to be allocated **/
+    size_t next_block_size_;
+    /** @brief the total number of bytes in all the blocks **/
+    size_t bytes_reserved_;
+    /** @brief the size of the first block **/
+    static const size_t initial_block_size_=1<<16;
+    /** @brief the blocks stop growing beyond this size **/
+    static const size_t max_block_size_=1<<24;
+public:
+    /*! Constructor */
+    Arena() : cur_(nullptr), left_(0), next_block_size_(initial_block_size_), bytes_reserved_(0) {}
+    /*! Destructor: frees all the blocks */
+    ~Arena() {
+        release();
+    }
+    Arena(const Arena&)=delete;
+    Arena& operator=(const Arena&)=delete;
+    /*! Allocate memory
+     * \param[in] bytes     the number of bytes
+     * \param[in] align     the alignment (a power of 2)
+     * \param[out] p        pointer to the allocated memory */
+    void* allocate(size_t bytes, size_t align=alignof(std::max_align_t)) {
+        size_t pad = (align - reinterpret_cast<std::uintptr_t>(cur_) % align) % align;
+        if (cur_==nullptr || pad+bytes>left_) {
+            /* open a new block which is large enough */
+            size_t size=next_block_size_;
+            while (size<bytes+align) {
+                size*=2;
+            }
+            if (next_block_size_<max_block_size_) {
+                next_block_size_*=2;
+            }
+            char* block=static_cast<char*>(::operator new(size));
+            blocks_.push_back(block);
+            bytes_reserved_+=size;
+            cur_=block;
+            left_=size;
+            pad=(align - reinterpret_cast<std::uintptr_t>(cur_) % align) % align;
+        }
+        void* p=cur_+pad;
+        cur_+=pad+bytes;
+        left_-=pad+bytes;
+        return p;
+    }
+    /*! Construct an object in the arena (its destructor is never called)
+     * \param[in] args      the arguments passed to the constructor
+     * \param[out] p        pointer to the constructed object */
+    template<class T, class... Args>
+    T* create(Args&&... args) {
+        void* p=allocate(sizeof(T),alignof(T));
+        return new (p) T(std::forward<Args>(args)...);
+    }
+    /*! Give back all the memory at once. All objects allocated from the arena become invalid. */
+    void release() {
+        for (size_t i=0; i<blocks_.size(); i++) {
+            ::operator delete(blocks_[i]);
+        }
+        blocks_.clear();
+        cur_=nullptr;
+        left_=0;
+        next_block_size_=initial_block_size_;
+        bytes_reserved_=0;
+    }
+    /*! The total number of bytes currently held by the arena */
+    size_t bytes_reserved() const {
+        return bytes_reserved_;
+    }
+};/* end of class definition */
+
+/**
+ *  @class ArenaAllocator
+ *
+ *  @brief STL allocator drawing memory from an Arena.
+ *
+ *  An allocator without an arena falls back to the global operator new and delete, so that containers which use this allocator can also live outside of any arena.
+ */
+template<class T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+    /** @brief the arena (nullptr for the global heap) **/
+    Arena* arena_;
+public:
+    /*! Constructor
+     * \param[in] arena     the arena to allocate from (nullptr for the global heap) */
+    ArenaAllocator(Arena* arena=nullptr) noexcept : arena_(arena) {}
+    /*! Rebinding constructor */
+    template<class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.arena_) {}
+    /*! Allocate memory for n objects */
+    T* allocate(size_t n) {
+        if (arena_!=nullptr) {
+            return static_cast<T*>(arena_->allocate(n*sizeof(T),alignof(T)));
+        } else {
+            return static_cast<T*>(::operator new(n*sizeof(T)));
+        }
+    }
+    /*! Deallocate memory (no-op inside an arena) */
+    void deallocate(T* p, size_t) noexcept {
+        if (arena_==nullptr) {
+            ::operator delete(p);
+        }
+    }
+};
+template<class T, class U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept {
+    return a.arena_==b.arena_;
+}
+template<class T, class U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept {
+    return a.arena_!=b.arena_;
+}
+
+}/* end of namespace negotiation */
+#endif
@@ -0,0 +1,661 @@
+/* Attractor.hpp
+ *
+ *  Date: 19/10/2026 */
+
+/** @file **/
+#ifndef ATTRACTOR_HPP_
+#define ATTRACTOR_HPP_
+
+#include <vector>
+#include <queue>
+#include <limits>
+#include <unordered_set>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+
+#include "Monitor.hpp"
+
+/** @namespace negotiation **/
+namespace negotiation {
+
+/**
+ *  @brief Sure semantics: the control input is chosen by the controller and all the disturbance inputs are adversarial. The counters and the strategies are indexed by state-control input pairs.
+ */
+struct SureSemantics {
+    static const bool sure=true;
+    /*! Number of counters per state */
+    static abs_type no_counters(Monitor& m) {
+        return m.no_control_inputs;
+    }
+    /*! Counter of the state-input triple (i,j,k) */
+    static abs_ptr_type counter(Monitor& m, const abs_type i, const abs_type j, const abs_type) {
+        return m.addr_xu(i,j);
+    }
+    /*! Input stored in the strategy for the control input j and the disturbance input k */
+    static abs_type input(Monitor&, const abs_type j, const abs_type) {
+        return j;
+    }
+    /*! The disturbance inputs sharing the counter of the disturbance input k: [dist_begin, dist_end) */
+    static abs_type dist_begin(Monitor&, const abs_type) {
+        return 0;
+    }
+    static abs_type dist_end(Monitor& m, const abs_type) {
+        return m.no_dist_inputs;
+    }
+};
+
+/**
+ *  @brief Maybe semantics: both the control and the disturbance inputs are chosen cooperatively. The counters and the strategies are indexed by state-joint input pairs.
+ */
+struct MaybeSemantics {
+    static const bool sure=false;
+    /*! Number of counters per state */
+    static abs_type no_counters(Monitor& m) {
+        return m.no_control_inputs*m.no_dist_inputs;
+    }
+    /*! Counter of the state-input triple (i,j,k) */
+    static abs_ptr_type counter(Monitor& m, const abs_type i, const abs_type j, const abs_type k) {
+        return m.addr_xuw(i,j,k);
+    }
+    /*! Input stored in the strategy for the control input j and the disturbance input k */
+    static abs_type input(Monitor& m, const abs_type j, const abs_type k) {
+        return m.addr_uw(j,k);
+    }
+    /*! The disturbance inputs sharing the counter of the disturbance input k: [dist_begin, dist_end) */
+    static abs_type dist_begin(Monitor&, const abs_type k) {
+        return k;
+    }
+    static abs_type dist_end(Monitor&, const abs_type k) {
+        return k+1;
+    }
+};
+
+/*! Count the posts of all the enabled transitions, per counter of the semantics.
+ * \param[in] m         the monitor
+ * \param[out] K        the number of posts indexed by the counters of the semantics */
+template<class Semantics>
+std::vector<abs_type> count_posts(Monitor& m) {
+    std::vector<abs_type> K(abs_ptr_type(m.no_states)*Semantics::no_counters(m),0);
+    for (abs_type i=0; i<m.no_states; i++) {
+        for (abs_type j=0; j<m.no_control_inputs; j++) {
+            for (abs_type k=0; k<m.no_dist_inputs; k++) {
+                K[Semantics::counter(m,i,j,k)]+=m.no_post(m.addr_xuw(i,j,k));
+            }
+        }
+    }
+    return K;
+}
+
+/**
+ *  @brief Safety objective: the states outside the safe set and the dead-ends are bad, and a state becomes bad when all its inputs lead to bad states. The strategy D keeps the inputs which are not known to lead to bad states.
+ *
+ *  In the local mode, only the states reachable from the initial states are solved: the status of a reachable state only depends on reachable states, and the unreachable states are marked bad without being propagated. Optionally, the propagation stops as soon as some initial state is bad.
+ */
+template<class Semantics>
+class SafetyObjective {
+public:
+    /** @brief the safe states **/
+    const std::unordered_set<abs_type>& safe_states_;
+    /** @brief the strategy (one set of inputs per state) **/
+    std::vector<arena_set*>& D_;
+    /** @brief the states known to be bad **/
+    std::vector<bool> bad_;
+    /** @brief solve only the states reachable from the initial states **/
+    const bool local_;
+    /** @brief stop as soon as some initial state is bad **/
+    const bool stop_at_bad_init_;
+    /** @brief the initial states **/
+    std::vector<bool> init_;
+    /** @brief true when some initial state is bad **/
+    bool bad_init_;
+    /** @brief [concurrent mode] the removed inputs, indexed by the counters of the semantics **/
+    std::vector<std::atomic<unsigned char>> removed_;
+    /** @brief [concurrent mode] the number of inputs left in the strategy of each state **/
+    std::vector<std::atomic<abs_type>> no_left_;
+    /** @brief [concurrent mode] the states known to be bad **/
+    std::vector<std::atomic<unsigned char>> bad_concurrent_;
+public:
+    /*! Constructor
+     * \param[in] safe_states       the safe states
+     * \param[in] D                 the strategy, which is overwritten
+     * \param[in] local             [Optional] solve only the states reachable from the initial states (the rest get an empty strategy)
+     * \param[in] stop_at_bad_init  [Optional] stop as soon as some initial state is bad (the strategy is then incomplete) */
+    SafetyObjective(const std::unordered_set<abs_type>& safe_states, std::vector<arena_set*>& D, const bool local=false, const bool stop_at_bad_init=false) : safe_states_(safe_states), D_(D), local_(local), stop_at_bad_init_(stop_at_bad_init) {}
+    /*! Seed the queue with the bad states and initialize the strategy of the rest with all the inputs having some successor */
+    void init(Monitor& m, std::queue<abs_type>& Q) {
+        bad_.assign(m.no_states,false);
+        init_.assign(m.no_states,false);
+        for (auto i=m.init_.begin(); i!=m.init_.end(); ++i) {
+            init_[*i]=true;
+        }
+        bad_init_=false;
+        if (local_) {
+            m.compute_reachable_bitset();
+        }
+        for (abs_type i=0; i<m.no_states; i++) {
+            D_[i]->clear();
+            /* the unreachable states have no reachable predecessors, so they need not be propagated */
+            if (local_ && !m.is_reachable(i)) {
+                bad_[i]=true;
+                continue;
+            }
+            if (safe_states_.find(i)==safe_states_.end() || isDeadEnd(m,i)) {
+                bad_init_=(bad_init_ || init_[i]);
+                Q.push(i);
+                bad_[i]=true;
+                continue;
+            }
+            for (abs_type j=0; j<m.no_control_inputs; j++) {
+                for (abs_type k=0; k<m.no_dist_inputs; k++) {
+                    if (m.no_post(m.addr_xuw(i,j,k))!=0) {
+                        D_[i]->insert(Semantics::input(m,j,k));
+                        /* for sure winning, one successor is enough to allow the control input */
+                        if (Semantics::sure) {
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    /*! The bad state x is a post of p for the inputs (j,k): remove the input from the strategy of p */
+    void visit(Monitor& m, const abs_type, const abs_type p, const abs_type j, const abs_type k, std::queue<abs_type>& Q) {
+        /* the strategy of a bad state is already empty */
+        if (bad_[p]) {
+            return;
+        }
+        D_[p]->erase(Semantics::input(m,j,k));
+        if (D_[p]->size()==0) {
+            Q.push(p);
+            bad_[p]=true;
+            bad_init_=(bad_init_ || init_[p]);
+        }
+    }
+    /*! Whether the propagation can stop before reaching the fixed point */
+    bool done() const {
+        return stop_at_bad_init_ && bad_init_;
+    }
+    /*! [concurrent mode] The bad states do not depend on the order of processing, so the concurrent mode is always supported */
+    bool concurrent() const {
+        return true;
+    }
+    /*! [concurrent mode] Set up the atomic flags and counters after init */
+    void prepare_concurrent(Monitor& m, const std::vector<abs_type>&) {
+        removed_=std::vector<std::atomic<unsigned char>>(abs_ptr_type(m.no_states)*Semantics::no_counters(m));
+        for (size_t i=0; i<removed_.size(); i++) {
+            removed_[i].store(0,std::memory_order_relaxed);
+        }
+        no_left_=std::vector<std::atomic<abs_type>>(m.no_states);
+        bad_concurrent_=std::vector<std::atomic<unsigned char>>(m.no_states);
+        for (abs_type i=0; i<m.no_states; i++) {
+            no_left_[i].store(D_[i]->size(),std::memory_order_relaxed);
+            bad_concurrent_[i].store(bad_[i],std::memory_order_relaxed);
+        }
+    }
+    /*! [concurrent mode] Same as visit, but the strategy is only updated in finish_concurrent; a state which becomes bad is appended to events */
+    void visit_concurrent(Monitor& m, const abs_type, const abs_type p, const abs_type j, const abs_type k, std::vector<abs_type>& events) {
+        if (bad_concurrent_[p].load(std::memory_order_relaxed)) {
+            return;
+        }
+        /* every input which leads to a post has been counted in no_left_ */
+        if (!removed_[Semantics::counter(m,p,j,k)].exchange(1) &&
+            no_left_[p].fetch_sub(1)==1 &&
+            !bad_concurrent_[p].exchange(1)) {
+            events.push_back(p);
+        }
+    }
+    /*! [concurrent mode] The new bad states form the next frontier (in any order) */
+    void end_level(Monitor&, const std::vector<abs_type>&, std::vector<abs_type>& events, std::vector<abs_type>& next) {
+        for (size_t n=0; n<events.size(); n++) {
+            bad_init_=(bad_init_ || init_[events[n]]);
+        }
+        next.swap(events);
+    }
+    /*! [concurrent mode] Remove the inputs flagged during the propagation from the strategy */
+    void finish_concurrent(Monitor& m) {
+        for (abs_type i=0; i<m.no_states; i++) {
+            if (bad_concurrent_[i].load(std::memory_order_relaxed)) {
+                bad_[i]=true;
+                D_[i]->clear();
+                continue;
+            }
+            for (auto l=D_[i]->begin(); l!=D_[i]->end(); ) {
+                /* the counter of the input: the inputs of the maybe semantics are joint inputs */
+                abs_ptr_type c=Semantics::counter(m,i,(Semantics::sure ? *l : *l/m.no_dist_inputs),(Semantics::sure ? 0 : *l%m.no_dist_inputs));
+                if (removed_[c].load(std::memory_order_relaxed)) {
+                    l=D_[i]->erase(l);
+                } else {
+                    ++l;
+                }
+            }
+        }
+        removed_.clear();
+        no_left_.clear();
+        bad_concurrent_.clear();
+    }
+private:
+    /*! Check if a given monitor state is a dead-end */
+    static bool isDeadEnd(Monitor& m, const abs_type i) {
+        for (abs_type j=0; j<m.no_control_inputs; j++) {
+            for (abs_type k=0; k<m.no_dist_inputs; k++) {
+                if (m.no_post(m.addr_xuw(i,j,k))!=0) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+};/* end of class definition */
+
+/**
+ *  @brief Reach-avoid objective: the targets have value 0, and a state outside the avoid set gets the value 1+(the largest value of the posts) of the first input whose posts have all been reached. The strategy D keeps the input with the optimal value.
+ *
+ *  With warm start, the counters, the values and the strategy are kept after the propagation, and the next propagation with a subset of the old targets only undoes the part which depended on the dropped targets: the dropped targets lose their values, and so (transitively) do the states whose strategy has a post without a value; for each pre-transition of such a state, the counter decremented when the state was reached is incremented again. The states which lost their values and still have a completed counter are seeded again, and the propagation continues from them. The states which keep their values are exactly the ones whose strategy only leads through kept states to the kept targets, so the reached states are the same as the ones of a propagation from scratch; the values then only bound the distance to the targets from above, which is enough for the strategy to reach the targets.
+ */
+template<class Semantics>
+class ReachAvoidObjective {
+public:
+    /** @brief the target states **/
+    const std::unordered_set<abs_type>& target_states_;
+    /** @brief the states to avoid **/
+    const std::unordered_set<abs_type>& avoid_states_;
+    /** @brief the disturbance inputs to ignore (only used for sure semantics) **/
+    const std::vector<arena_set*>& friendly_dist_;
+    /** @brief the number of posts which are not yet reached, indexed by the counters of the semantics **/
+    std::vector<abs_type> K_;
+    /** @brief the value function **/
+    std::vector<abs_type> V_;
+    /** @brief the intermediate values, indexed by the counters of the semantics **/
+    std::vector<abs_type> M_;
+    /** @brief the strategy (one set of inputs per state) **/
+    std::vector<arena_set*>& D_;
+    /** @brief the number of posts, indexed by the counters of the semantics (see count_posts) **/
+    const std::vector<abs_type>& no_posts_;
+    /** @brief [warm start] whether the counters are kept for the next propagation **/
+    const bool warm_start_;
+    /** @brief [warm start] whether the counters, the values and the strategy hold the result for old_targets_ **/
+    bool solved_;
+    /** @brief [warm start] the targets of the last propagation **/
+    std::unordered_set<abs_type> old_targets_;
+    /** @brief [concurrent mode] the counters **/
+    std::vector<std::atomic<abs_type>> K_concurrent_;
+    /** @brief [concurrent mode] the position of each state of the current frontier in the frontier **/
+    std::vector<abs_type> pos_;
+    /** @brief [concurrent mode] the value of the states in the current frontier **/
+    abs_type level_;
+    /** @brief [concurrent mode] the earliest completed counter (see end_level) of the states reached from the current frontier **/
+    std::vector<uint64_t> first_;
+public:
+    /*! Constructor
+     * \param[in] target_states     the target states
+     * \param[in] avoid_states      the states to avoid
+     * \param[in] friendly_dist     the disturbance inputs to ignore
+     * \param[in] no_posts          the number of posts (see count_posts), which must stay valid as long as the objective is used
+     * \param[in] D                 the strategy, which is overwritten
+     * \param[in] warm_start        [Optional] keep the counters, so that the next propagation with a subset of the targets (and the same transitions) starts from the result of this one (default: false) */
+    ReachAvoidObjective(const std::unordered_set<abs_type>& target_states,
+                        const std::unordered_set<abs_type>& avoid_states,
+                        const std::vector<arena_set*>& friendly_dist,
+                        const std::vector<abs_type>& no_posts,
+                        std::vector<arena_set*>& D,
+                        const bool warm_start=false) : target_states_(target_states), avoid_states_(avoid_states), friendly_dist_(friendly_dist), D_(D), no_posts_(no_posts), warm_start_(warm_start), solved_(false) {}
+    /*! Seed the queue with the targets and initialize the values (the optimal input of a target is 0, chosen arbitrarily), or with warm start, undo the part of the last result which depended on the dropped targets */
+    void init(Monitor& m, std::queue<abs_type>& Q) {
+        bool targets_shrunk=solved_;
+        for (auto i=target_states_.begin(); i!=target_states_.end() && targets_shrunk; ++i) {
+            targets_shrunk=(old_targets_.find(*i)!=old_targets_.end());
+        }
+        if (warm_start_) {
+            solved_=true;
+            old_targets_=target_states_;
+        }
+        if (targets_shrunk) {
+            drop_targets(m,Q);
+            return;
+        }
+        for (auto i=target_states_.begin(); i!=target_states_.end(); ++i) {
+            Q.push(*i);
+        }
+        K_=no_posts_;
+        M_.assign(abs_ptr_type(m.no_states)*Semantics::no_counters(m),0);
+        V_.assign(m.no_states,std::numeric_limits<abs_type>::max());
+        for (abs_type i=0; i<m.no_states; i++) {
+            D_[i]->clear();
+            if (target_states_.find(i)!=target_states_.end()) {
+                V_[i]=0;
+                D_[i]->insert(0);
+            }
+        }
+    }
+    /*! The state x with a known value is a post of p for the inputs (j,k): update the counter of p */
+    void visit(Monitor& m, const abs_type x, const abs_type p, const abs_type j, const abs_type k, std::queue<abs_type>& Q) {
+        if (avoid_states_.find(p)!=avoid_states_.end()) {
+            return;
+        }
+        abs_ptr_type c=Semantics::counter(m,p,j,k);
+        /* if the current disturbance input is friendly, then all the non-deterministic posts are favorable, otherwise just one post (leading to x) is favorable */
+        if (Semantics::sure && friendly_dist_[p]->find(k)!=friendly_dist_[p]->end()) {
+            K_[c]-=m.no_post(m.addr_xuw(p,j,k));
+        } else {
+            K_[c]--;
+        }
+        M_[c]=(M_[c]>=1+V_[x] ? M_[c] : 1+V_[x]);
+        if (!K_[c] && V_[p]>M_[c]) {
+            /* a state is propagated once: a smaller value found later (only after a warm start) only makes the values of its predecessors larger than needed */
+            if (V_[p]==std::numeric_limits<abs_type>::max()) {
+                Q.push(p);
+            }
+            V_[p]=M_[c];
+            D_[p]->clear();
+            D_[p]->insert(Semantics::input(m,j,k));
+        }
+    }
+    /*! The propagation always runs until the fixed point */
+    bool done() const {
+        return false;
+    }
+    /*! [concurrent mode] The concurrent mode reproduces the order of the sequential solver from the structure of the transitions, which is not possible when a friendly disturbance input discounts several posts at once */
+    bool concurrent() const {
+        /* a warm start does not propagate level by level */
+        if (solved_) {
+            return false;
+        }
+        if (Semantics::sure) {
+            for (size_t i=0; i<friendly_dist_.size(); i++) {
+                if (friendly_dist_[i]->size()!=0) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    /*! [concurrent mode] Set up the atomic counters after init
+     * \param[in] frontier      the targets, in the order of the queue */
+    void prepare_concurrent(Monitor& m, const std::vector<abs_type>& frontier) {
+        K_concurrent_=std::vector<std::atomic<abs_type>>(K_.size());
+        for (size_t c=0; c<K_.size(); c++) {
+            K_concurrent_[c].store(K_[c],std::memory_order_relaxed);
+        }
+        pos_.assign(m.no_states,0);
+        for (size_t n=0; n<frontier.size(); n++) {
+            pos_[frontier[n]]=n;
+        }
+        level_=0;
+        first_.assign(m.no_states,std::numeric_limits<uint64_t>::max());
+    }
+    /*! [concurrent mode] Same as visit, but the values and the strategy are only updated in end_level; the counters which are completed are appended to events as (p,j,k) */
+    void visit_concurrent(Monitor& m, const abs_type, const abs_type p, const abs_type j, const abs_type k, std::vector<abs_type>& events) {
+        if (avoid_states_.find(p)!=avoid_states_.end()) {
+            return;
+        }
+        if (K_concurrent_[Semantics::counter(m,p,j,k)].fetch_sub(1)==1 &&
+            V_[p]==std::numeric_limits<abs_type>::max()) {
+            events.push_back(p);
+            events.push_back(j);
+            events.push_back(k);
+        }
+    }
+    /*! [concurrent mode] Assign the next value to the states reached from the frontier, in the order in which the sequential solver would push them.
+     *
+     * The sequential solver completes a counter with its last decrement, i.e. the largest (position of the post in the frontier, input) over the posts in the frontier, and a state takes the input of its first completed counter. States completed by the same decrement are pushed in the order of the pre set.
+     * \param[in] frontier      the current frontier
+     * \param[in] events        the completed counters
+     * \param[out] next         the next frontier */
+    void end_level(Monitor& m, const std::vector<abs_type>& frontier, std::vector<abs_type>& events, std::vector<abs_type>& next) {
+        const uint64_t none=std::numeric_limits<uint64_t>::max();
+        next.clear();
+        for (size_t e=0; e<events.size(); e+=3) {
+            abs_type p=events[e], j=events[e+1], k=events[e+2];
+            uint64_t key=0;
+            for (abs_type k2=Semantics::dist_begin(m,k); k2<Semantics::dist_end(m,k); k2++) {
+                abs_ptr_type l=m.addr_xuw(p,j,k2);
+                if (!m.enabled_[l]) {
+                    continue;
+                }
+                m.for_each_post(l,[&](const abs_type y) {
+                    if (V_[y]==level_) {
+                        key=std::max(key,(uint64_t(pos_[y])<<32) | (j*m.no_dist_inputs+k2));
+                    }
+                });
+            }
+            if (first_[p]==none) {
+                next.push_back(p);
+            }
+            first_[p]=std::min(first_[p],key);
+        }
+        std::sort(next.begin(),next.end(),[&](const abs_type a, const abs_type b) {
+            return first_[a]<first_[b];
+        });
+        for (size_t n=0; n<next.size(); ) {
+            size_t n2=n+1;
+            while (n2<next.size() && first_[next[n2]]==first_[next[n]]) {
+                n2++;
+            }
+            if (n2-n>1) {
+                /* ties: follow the pre set of the decrement */
+                uint64_t key=first_[next[n]];
+                abs_type y=frontier[key>>32];
+                abs_type jk=key & 0xffffffff;
+                std::unordered_set<abs_type> tied(next.begin()+n,next.begin()+n2);
+                size_t n3=n;
+                m.for_each_pre(m.addr_xuw(y,jk/m.no_dist_inputs,jk%m.no_dist_inputs),[&](const abs_type i) {
+                    if (tied.find(i)!=tied.end()) {
+                        next[n3++]=i;
+                    }
+                });
+            }
+            n=n2;
+        }
+        level_++;
+        for (size_t n=0; n<next.size(); n++) {
+            abs_type p=next[n];
+            abs_type jk=first_[p] & 0xffffffff;
+            V_[p]=level_;
+            pos_[p]=n;
+            D_[p]->clear();
+            D_[p]->insert(Semantics::input(m,jk/m.no_dist_inputs,jk%m.no_dist_inputs));
+            first_[p]=none;
+        }
+    }
+    /*! [concurrent mode] The strategy is updated in end_level; with warm start, the counters and the intermediate values are brought to the state the sequential mode leaves them in */
+    void finish_concurrent(Monitor& m) {
+        if (warm_start_) {
+            for (size_t c=0; c<K_.size(); c++) {
+                K_[c]=K_concurrent_[c].load(std::memory_order_relaxed);
+            }
+            for (abs_type x=0; x<m.no_states; x++) {
+                if (V_[x]==std::numeric_limits<abs_type>::max()) {
+                    continue;
+                }
+                for_each_counted_pre(m,x,[&](const abs_type p, const abs_type j, const abs_type k) {
+                    abs_ptr_type c=Semantics::counter(m,p,j,k);
+                    M_[c]=std::max(M_[c],1+V_[x]);
+                });
+            }
+        }
+        K_concurrent_.clear();
+    }
+private:
+    /*! Visit the pre-transitions (p,j,k) of the state x which decrement a counter when x is reached (the enabled ones from outside the avoid set) */
+    template<class F>
+    void for_each_counted_pre(Monitor& m, const abs_type x, F f) {
+        for (abs_type j=0; j<m.no_control_inputs; j++) {
+            for (abs_type k=0; k<m.no_dist_inputs; k++) {
+                m.for_each_pre(m.addr_xuw(x,j,k),[&](const abs_type p) {
+                    if (m.enabled_[m.addr_xuw(p,j,k)] && avoid_states_.find(p)==avoid_states_.end()) {
+                        f(p,j,k);
+                    }
+                });
+            }
+        }
+    }
+    /*! [warm start] Undo the part of the last result which depended on the targets which are no longer targets, and seed the queue with the states which lost their values but still have a completed counter */
+    void drop_targets(Monitor& m, std::queue<abs_type>& Q) {
+        const abs_type none=std::numeric_limits<abs_type>::max();
+        /* the states which lost their values, in the order in which they lost them */
+        std::vector<abs_type> dropped;
+        for (abs_type i=0; i<m.no_states; i++) {
+            if (V_[i]==0 && target_states_.find(i)==target_states_.end()) {
+                V_[i]=none;
+                D_[i]->clear();
+                dropped.push_back(i);
+            }
+        }
+        for (size_t n=0; n<dropped.size(); n++) {
+            for_each_counted_pre(m,dropped[n],[&](const abs_type p, const abs_type j, const abs_type k) {
+                abs_ptr_type c=Semantics::counter(m,p,j,k);
+                if (Semantics::sure && friendly_dist_[p]->find(k)!=friendly_dist_[p]->end()) {
+                    K_[c]+=m.no_post(m.addr_xuw(p,j,k));
+                } else {
+                    K_[c]++;
+                }
+                /* the strategy of p leads to a state without a value */
+                if (V_[p]!=none && target_states_.find(p)==target_states_.end() &&
+                    D_[p]->find(Semantics::input(m,j,k))!=D_[p]->end()) {
+                    V_[p]=none;
+                    D_[p]->clear();
+                    dropped.push_back(p);
+                }
+            });
+        }
+        /* the dropped states which can still reach the kept states with some input get the best such input */
+        for (size_t n=0; n<dropped.size(); n++) {
+            abs_type p=dropped[n];
+            if (avoid_states_.find(p)!=avoid_states_.end()) {
+                continue;
+            }
+            abs_type best=none, best_input=0;
+            for (abs_type j=0; j<m.no_control_inputs; j++) {
+                for (abs_type k=0; k<m.no_dist_inputs; k++) {
+                    abs_ptr_type c=Semantics::counter(m,p,j,k);
+                    if (no_posts_[c]!=0 && K_[c]==0 && M_[c]<best) {
+                        best=M_[c];
+                        best_input=Semantics::input(m,j,k);
+                    }
+                    /* the sure semantics has one counter for all the disturbance inputs */
+                    if (Semantics::sure) {
+                        break;
+                    }
+                }
+            }
+            if (best!=none) {
+                V_[p]=best;
+                D_[p]->insert(best_input);
+                Q.push(p);
+            }
+        }
+    }
+};/* end of class definition */
+
+/*! Backward propagation over the enabled transitions of a monitor, shared by all the games (sequential mode).
+ *
+ * The objective seeds the queue, and is notified of every enabled pre-transition of every state popped from the queue; it decides which predecessors are pushed, and whether the propagation can stop early. The semantics and the objective are template parameters, so all the branches on them are resolved at compile time.
+ * \param[in] m             the monitor
+ * \param[in] objective     the objective (SafetyObjective or ReachAvoidObjective) */
+template<class Objective>
+void solve_attractor(Monitor& m, Objective& objective) {
+    std::queue<abs_type> Q;
+    objective.init(m,Q);
+    while (Q.size()!=0 && !objective.done()) {
+        abs_type x=Q.front();
+        Q.pop();
+        for (abs_type j=0; j<m.no_control_inputs; j++) {
+            for (abs_type k=0; k<m.no_dist_inputs; k++) {
+                m.for_each_pre(m.addr_xuw(x,j,k),[&](const abs_type i) {
+                    /* skip the disabled transitions */
+                    if (m.enabled_[m.addr_xuw(i,j,k)]) {
+                        objective.visit(m,x,i,j,k,Q);
+                    }
+                });
+            }
+        }
+    }
+}
+
+/*! Backward propagation over the enabled transitions of a monitor, level-synchronous and parallel (concurrent mode).
+ *
+ * The states of the current frontier are expanded over pre by no_threads threads (frontiers smaller than Monitor::min_parallel_frontier_ by the calling thread alone), which update the atomic counters of the objective and append the events to thread-local buffers. The objective then forms the next frontier from the events. The outcome is the same as the one of the sequential mode, which is used when no_threads<=1 or when the objective does not support the concurrent mode.
+ *
+ * The transitions of a memory-mapped monitor (see Monitor::is_mapped) are always propagated level by level, also by a single thread: the states of a level are expanded in increasing order, so that the pre array is read sequentially, and the pages read are dropped from the resident memory after every level.
+ * \param[in] m             the monitor
+ * \param[in] objective     the objective (SafetyObjective or ReachAvoidObjective)
+ * \param[in] no_threads    the number of threads */
+template<class Objective>
+void solve_attractor(Monitor& m, Objective& objective, const int no_threads) {
+    if ((no_threads<=1 && !m.is_mapped()) || !objective.concurrent()) {
+        solve_attractor(m,objective);
+        return;
+    }
+    const int no_workers=std::max(no_threads,1);
+    /* number of frontier states taken by a thread at once */
+    const size_t grain=256;
+    std::queue<abs_type> Q;
+    objective.init(m,Q);
+    std::vector<abs_type> frontier, next, events;
+    while (Q.size()!=0) {
+        frontier.push_back(Q.front());
+        Q.pop();
+    }
+    objective.prepare_concurrent(m,frontier);
+    std::vector<std::vector<abs_type>> local(no_workers);
+    /* the frontier in increasing order (memory-mapped monitors only) */
+    std::vector<abs_type> sorted;
+    while (frontier.size()!=0 && !objective.done()) {
+        const std::vector<abs_type>* expanded=&frontier;
+        if (m.is_mapped()) {
+            sorted=frontier;
+            std::sort(sorted.begin(),sorted.end());
+            expanded=&sorted;
+        }
+        std::atomic<size_t> cursor(0);
+        auto expand = [&](const int t) {
+            while (true) {
+                size_t begin=cursor.fetch_add(grain);
+                if (begin>=expanded->size()) {
+                    break;
+                }
+                size_t end=std::min(begin+grain,expanded->size());
+                for (size_t n=begin; n<end; n++) {
+                    abs_type x=(*expanded)[n];
+                    for (abs_type j=0; j<m.no_control_inputs; j++) {
+                        for (abs_type k=0; k<m.no_dist_inputs; k++) {
+                            m.for_each_pre(m.addr_xuw(x,j,k),[&](const abs_type i) {
+                                if (m.enabled_[m.addr_xuw(i,j,k)]) {
+                                    objective.visit_concurrent(m,x,i,j,k,local[t]);
+                                }
+                            });
+                        }
+                    }
+                }
+            }
+        };
+        for (int t=0; t<no_workers; t++) {
+            local[t].clear();
+        }
+        if (no_workers==1 || frontier.size()<m.min_parallel_frontier_) {
+            expand(0);
+        } else {
+            std::vector<std::thread> threads;
+            for (int t=1; t<no_workers; t++) {
+                threads.push_back(std::thread(expand,t));
+            }
+            expand(0);
+            for (size_t t=0; t<threads.size(); t++) {
+                threads[t].join();
+            }
+        }
+        events.clear();
+        for (int t=0; t<no_workers; t++) {
+            events.insert(events.end(),local[t].begin(),local[t].end());
+        }
+        objective.end_level(m,frontier,events,next);
+        frontier.swap(next);
+        m.release_mapped();
+    }
+    objective.finish_concurrent(m);
+}
+
+}/* end of namespace negotiation */
+#endif
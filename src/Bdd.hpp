@@ -0,0 +1,714 @@
+/* Bdd.hpp
+ *
+ *  Date: 19/10/2026 */
+
+/** @file **/
+#ifndef BDD_HPP_
+#define BDD_HPP_
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+
+/** @namespace negotiation **/
+namespace negotiation {
+
+/** @brief the index of a BDD node in the node table of its manager **/
+using bdd_node=std::uint32_t;
+
+class Bdd;
+
+/**
+ *  @class BddManager
+ *
+ *  @brief A package of reduced ordered binary decision diagrams.
+ *
+ *  The nodes live in one table; the nodes 0 and 1 are the constants false and true. Every variable has its own unique table, which maps the pair of children of a node to the node, so that every function has exactly one node. The results of the recursive operations are memoized in a direct-mapped computed cache.
+ *
+ *  Every node counts its references: one for every node of the table pointing to it, and one for every Bdd handle. The nodes which are not referenced anymore stay in the table until the next garbage collection, which only happens between two operations (see checkpoint), so that the intermediate results of an operation need not be referenced.
+ *
+ *  The variables can be reordered in place by sifting: every variable is moved through all the levels by swapping adjacent levels, and is put back at the level where the table was smallest. The nodes keep their indices (and their functions) during reordering, so the Bdd handles stay valid. Reordering is triggered automatically when the table grows beyond a threshold, unless it is disabled.
+ */
+class BddManager {
+private:
+    /** @brief a node: its variable and its children for the variable being false (lo) and true (hi) **/
+    struct Node {
+        std::uint32_t var_;
+        bdd_node lo_, hi_;
+        std::uint32_t ref_;
+    };
+    /** @brief the operations memoized in the computed cache **/
+    enum Op : std::uint32_t {op_and=1, op_or, op_xor, op_not, op_ite, op_exists, op_and_exists};
+    /** @brief an entry of the computed cache **/
+    struct CacheEntry {
+        std::uint32_t op_;
+        bdd_node a_, b_, c_, r_;
+    };
+    /** @brief the number of variables **/
+    std::uint32_t no_vars_;
+    /** @brief the node table **/
+    std::vector<Node> nodes_;
+    /** @brief the indices of the free slots of the node table **/
+    std::vector<bdd_node> free_;
+    /** @brief the number of nodes in the table (including the two constants) **/
+    size_t no_nodes_;
+    /** @brief the unique table of every variable, keyed by the children **/
+    std::vector<std::unordered_map<std::uint64_t,bdd_node>> unique_;
+    /** @brief the level of every variable (the constants have the level no_vars_) and the variable at every level **/
+    std::vector<std::uint32_t> level_, var_at_;
+    /** @brief the computed cache **/
+    std::vector<CacheEntry> cache_;
+    /** @brief the garbage is collected when the table grows beyond this size **/
+    size_t gc_threshold_;
+    /** @brief the variables are reordered when the table grows beyond this size after garbage collection **/
+    size_t reorder_threshold_;
+    /** @brief whether reordering is triggered automatically **/
+    bool auto_reorder_;
+    /** @brief the table may grow by this factor while sifting a variable before the variable is turned back **/
+    static constexpr double max_growth_=1.2;
+public:
+    /*! Constructor
+     * \param[in] no_vars       the number of variables (the initial order is the order of their indices)
+     * \param[in] cache_bits    [Optional] the computed cache has 2^cache_bits entries */
+    BddManager(const std::uint32_t no_vars, const unsigned cache_bits=18) : no_vars_(no_vars), no_nodes_(2), unique_(no_vars), cache_(size_t(1)<<cache_bits), gc_threshold_(1<<16), reorder_threshold_(1<<14), auto_reorder_(true) {
+        /* the constants are never freed */
+        nodes_.push_back(Node{no_vars_,0,0,1});
+        nodes_.push_back(Node{no_vars_,1,1,1});
+        for (std::uint32_t v=0; v<=no_vars_; v++) {
+            level_.push_back(v);
+        }
+        for (std::uint32_t v=0; v<no_vars_; v++) {
+            var_at_.push_back(v);
+        }
+        clear_cache();
+    }
+    BddManager(const BddManager&)=delete;
+    BddManager& operator=(const BddManager&)=delete;
+    /*! The number of variables */
+    std::uint32_t no_vars() const {
+        return no_vars_;
+    }
+    /*! The number of nodes in the table, including the unreferenced ones which were not collected yet */
+    size_t no_nodes() const {
+        return no_nodes_;
+    }
+    /*! The level of a variable */
+    std::uint32_t level(const std::uint32_t var) const {
+        return level_[var];
+    }
+    /*! Enable or disable the automatic reordering */
+    void auto_reorder(const bool enable) {
+        auto_reorder_=enable;
+    }
+    /*! The constants and the literals */
+    Bdd zero();
+    Bdd one();
+    Bdd var(const std::uint32_t v);
+    Bdd nvar(const std::uint32_t v);
+    /*! The conjunction of the given variables (for quantification) */
+    Bdd cube(const std::vector<std::uint32_t>& vars);
+    /*! The conjunction of the literals encoding value in binary over vars (vars[0] is the least significant bit) */
+    Bdd encode(const std::vector<std::uint32_t>& vars, std::uint64_t value);
+    /*! Reclaim the nodes which are not referenced anymore, and clear the computed cache */
+    void collect_garbage() {
+        std::vector<bdd_node> dead;
+        for (bdd_node f=2; f<nodes_.size(); f++) {
+            if (nodes_[f].ref_==0 && nodes_[f].var_<no_vars_) {
+                dead.push_back(f);
+            }
+        }
+        for (size_t n=0; n<dead.size(); n++) {
+            release_node(dead[n]);
+        }
+        clear_cache();
+    }
+    /*! Reorder the variables by sifting */
+    void reorder() {
+        collect_garbage();
+        /* the variables with the most nodes are sifted first */
+        std::vector<std::uint32_t> vars(var_at_);
+        std::stable_sort(vars.begin(),vars.end(),[&](const std::uint32_t a, const std::uint32_t b) {
+            return unique_[a].size()>unique_[b].size();
+        });
+        for (size_t n=0; n<vars.size(); n++) {
+            sift(vars[n]);
+        }
+        clear_cache();
+    }
+    /*! Called by the Bdd handles before every operation: collect the garbage and reorder the variables when the table has grown enough */
+    void checkpoint() {
+        if (no_nodes_<gc_threshold_) {
+            return;
+        }
+        collect_garbage();
+        if (auto_reorder_ && no_nodes_>=reorder_threshold_) {
+            reorder();
+            reorder_threshold_=std::max(reorder_threshold_,2*no_nodes_);
+        }
+        /* if most of the nodes are alive, let the table grow before the next collection */
+        if (4*no_nodes_>=3*gc_threshold_) {
+            gc_threshold_*=2;
+        }
+    }
+    /*! Reference counting of the Bdd handles */
+    void ref(const bdd_node f) {
+        nodes_[f].ref_++;
+    }
+    void deref(const bdd_node f) {
+        nodes_[f].ref_--;
+    }
+    /*! The operations on nodes (the arguments are held by Bdd handles, the results are not referenced) */
+    bdd_node apply_and(const bdd_node f, const bdd_node g) {
+        if (f==0 || g==0) {
+            return 0;
+        }
+        if (f==1 || f==g) {
+            return g;
+        }
+        if (g==1) {
+            return f;
+        }
+        bdd_node a=std::min(f,g), b=std::max(f,g);
+        bdd_node r;
+        if (cache_lookup(op_and,a,b,0,r)) {
+            return r;
+        }
+        std::uint32_t v=top_var(a,b);
+        bdd_node lo=apply_and(cofactor(a,v,false),cofactor(b,v,false));
+        bdd_node hi=apply_and(cofactor(a,v,true),cofactor(b,v,true));
+        r=mk(v,lo,hi);
+        cache_insert(op_and,a,b,0,r);
+        return r;
+    }
+    bdd_node apply_or(const bdd_node f, const bdd_node g) {
+        if (f==1 || g==1) {
+            return 1;
+        }
+        if (f==0 || f==g) {
+            return g;
+        }
+        if (g==0) {
+            return f;
+        }
+        bdd_node a=std::min(f,g), b=std::max(f,g);
+        bdd_node r;
+        if (cache_lookup(op_or,a,b,0,r)) {
+            return r;
+        }
+        std::uint32_t v=top_var(a,b);
+        bdd_node lo=apply_or(cofactor(a,v,false),cofactor(b,v,false));
+        bdd_node hi=apply_or(cofactor(a,v,true),cofactor(b,v,true));
+        r=mk(v,lo,hi);
+        cache_insert(op_or,a,b,0,r);
+        return r;
+    }
+    bdd_node apply_xor(const bdd_node f, const bdd_node g) {
+        if (f==g) {
+            return 0;
+        }
+        if (f==0) {
+            return g;
+        }
+        if (g==0) {
+            return f;
+        }
+        if (f==1) {
+            return apply_not(g);
+        }
+        if (g==1) {
+            return apply_not(f);
+        }
+        bdd_node a=std::min(f,g), b=std::max(f,g);
+        bdd_node r;
+        if (cache_lookup(op_xor,a,b,0,r)) {
+            return r;
+        }
+        std::uint32_t v=top_var(a,b);
+        bdd_node lo=apply_xor(cofactor(a,v,false),cofactor(b,v,false));
+        bdd_node hi=apply_xor(cofactor(a,v,true),cofactor(b,v,true));
+        r=mk(v,lo,hi);
+        cache_insert(op_xor,a,b,0,r);
+        return r;
+    }
+    bdd_node apply_not(const bdd_node f) {
+        if (f<=1) {
+            return 1-f;
+        }
+        bdd_node r;
+        if (cache_lookup(op_not,f,0,0,r)) {
+            return r;
+        }
+        bdd_node lo=apply_not(nodes_[f].lo_);
+        bdd_node hi=apply_not(nodes_[f].hi_);
+        r=mk(nodes_[f].var_,lo,hi);
+        cache_insert(op_not,f,0,0,r);
+        return r;
+    }
+    /*! If f then g else h */
+    bdd_node apply_ite(const bdd_node f, const bdd_node g, const bdd_node h) {
+        if (f==1) {
+            return g;
+        }
+        if (f==0) {
+            return h;
+        }
+        if (g==h) {
+            return g;
+        }
+        if (g==1 && h==0) {
+            return f;
+        }
+        bdd_node r;
+        if (cache_lookup(op_ite,f,g,h,r)) {
+            return r;
+        }
+        std::uint32_t v=top_var(f,g);
+        if (level_[nodes_[h].var_]<level_[v]) {
+            v=nodes_[h].var_;
+        }
+        bdd_node lo=apply_ite(cofactor(f,v,false),cofactor(g,v,false),cofactor(h,v,false));
+        bdd_node hi=apply_ite(cofactor(f,v,true),cofactor(g,v,true),cofactor(h,v,true));
+        r=mk(v,lo,hi);
+        cache_insert(op_ite,f,g,h,r);
+        return r;
+    }
+    /*! Existential quantification of the variables of the cube c */
+    bdd_node apply_exists(const bdd_node f, bdd_node c) {
+        if (f<=1) {
+            return f;
+        }
+        /* skip the quantified variables above f */
+        while (c>1 && level_[nodes_[c].var_]<level_[nodes_[f].var_]) {
+            c=nodes_[c].hi_;
+        }
+        if (c<=1) {
+            return f;
+        }
+        bdd_node r;
+        if (cache_lookup(op_exists,f,c,0,r)) {
+            return r;
+        }
+        std::uint32_t v=nodes_[f].var_;
+        if (nodes_[c].var_==v) {
+            bdd_node lo=apply_exists(nodes_[f].lo_,nodes_[c].hi_);
+            r=(lo==1 ? 1 : apply_or(lo,apply_exists(nodes_[f].hi_,nodes_[c].hi_)));
+        } else {
+            bdd_node lo=apply_exists(nodes_[f].lo_,c);
+            bdd_node hi=apply_exists(nodes_[f].hi_,c);
+            r=mk(v,lo,hi);
+        }
+        cache_insert(op_exists,f,c,0,r);
+        return r;
+    }
+    /*! Existential quantification of the variables of the cube c from the conjunction of f and g (relational product) */
+    bdd_node apply_and_exists(const bdd_node f, const bdd_node g, bdd_node c) {
+        if (f==0 || g==0) {
+            return 0;
+        }
+        if (f==1 && g==1) {
+            return 1;
+        }
+        if (f==1 || f==g) {
+            return apply_exists(g,c);
+        }
+        if (g==1) {
+            return apply_exists(f,c);
+        }
+        bdd_node a=std::min(f,g), b=std::max(f,g);
+        std::uint32_t v=top_var(a,b);
+        while (c>1 && level_[nodes_[c].var_]<level_[v]) {
+            c=nodes_[c].hi_;
+        }
+        if (c<=1) {
+            return apply_and(a,b);
+        }
+        bdd_node r;
+        if (cache_lookup(op_and_exists,a,b,c,r)) {
+            return r;
+        }
+        if (nodes_[c].var_==v) {
+            bdd_node lo=apply_and_exists(cofactor(a,v,false),cofactor(b,v,false),nodes_[c].hi_);
+            r=(lo==1 ? 1 : apply_or(lo,apply_and_exists(cofactor(a,v,true),cofactor(b,v,true),nodes_[c].hi_)));
+        } else {
+            bdd_node lo=apply_and_exists(cofactor(a,v,false),cofactor(b,v,false),c);
+            bdd_node hi=apply_and_exists(cofactor(a,v,true),cofactor(b,v,true),c);
+            r=mk(v,lo,hi);
+        }
+        cache_insert(op_and_exists,a,b,c,r);
+        return r;
+    }
+    /*! Rename the variables: the variable v of f becomes the variable perm[v] (the memo is local to one call) */
+    bdd_node apply_permute(const bdd_node f, const std::vector<std::uint32_t>& perm, std::unordered_map<bdd_node,bdd_node>& memo) {
+        if (f<=1) {
+            return f;
+        }
+        auto it=memo.find(f);
+        if (it!=memo.end()) {
+            return it->second;
+        }
+        bdd_node lo=apply_permute(nodes_[f].lo_,perm,memo);
+        bdd_node hi=apply_permute(nodes_[f].hi_,perm,memo);
+        bdd_node r=apply_ite(mk(perm[nodes_[f].var_],0,1),hi,lo);
+        memo[f]=r;
+        return r;
+    }
+    /*! Whether the assignment (indexed by the variables) satisfies f */
+    bool evaluate(bdd_node f, const std::vector<bool>& assignment) const {
+        while (f>1) {
+            f=(assignment[nodes_[f].var_] ? nodes_[f].hi_ : nodes_[f].lo_);
+        }
+        return f==1;
+    }
+    /*! The number of nodes of f (including the constants) */
+    size_t size(const bdd_node f) const {
+        std::vector<bdd_node> stack(1,f);
+        std::unordered_map<bdd_node,bool> seen;
+        seen[f]=true;
+        while (stack.size()!=0) {
+            bdd_node g=stack.back();
+            stack.pop_back();
+            if (g<=1) {
+                continue;
+            }
+            for (bdd_node h : {nodes_[g].lo_, nodes_[g].hi_}) {
+                if (seen.insert(std::make_pair(h,true)).second) {
+                    stack.push_back(h);
+                }
+            }
+        }
+        return seen.size();
+    }
+    /*! The node of the literal of the variable v */
+    bdd_node var_node(const std::uint32_t v) {
+        return mk(v,0,1);
+    }
+private:
+    /*! The node (var,lo,hi), created unless it exists already */
+    bdd_node mk(const std::uint32_t var, const bdd_node lo, const bdd_node hi) {
+        if (lo==hi) {
+            return lo;
+        }
+        std::uint64_t key=(std::uint64_t(lo)<<32) | hi;
+        auto it=unique_[var].find(key);
+        if (it!=unique_[var].end()) {
+            return it->second;
+        }
+        bdd_node f;
+        if (free_.size()!=0) {
+            f=free_.back();
+            free_.pop_back();
+            nodes_[f]=Node{var,lo,hi,0};
+        } else {
+            if (nodes_.size()>=std::numeric_limits<bdd_node>::max()) {
+                throw std::runtime_error("BddManager:mk: the node table is full.");
+            }
+            f=bdd_node(nodes_.size());
+            nodes_.push_back(Node{var,lo,hi,0});
+        }
+        nodes_[lo].ref_++;
+        nodes_[hi].ref_++;
+        unique_[var][key]=f;
+        no_nodes_++;
+        return f;
+    }
+    /*! Free an unreferenced node, and the nodes which are not referenced anymore as a consequence */
+    void release_node(const bdd_node f0) {
+        std::vector<bdd_node> stack(1,f0);
+        while (stack.size()!=0) {
+            bdd_node f=stack.back();
+            stack.pop_back();
+            Node& n=nodes_[f];
+            unique_[n.var_].erase((std::uint64_t(n.lo_)<<32) | n.hi_);
+            for (bdd_node g : {n.lo_, n.hi_}) {
+                if (--nodes_[g].ref_==0 && g>1) {
+                    stack.push_back(g);
+                }
+            }
+            /* the variable no_vars_ marks a free slot */
+            n.var_=no_vars_;
+            free_.push_back(f);
+            no_nodes_--;
+        }
+    }
+    /*! Drop one reference from the table to f, freeing it when it was the last one */
+    void deref_node(const bdd_node f) {
+        if (--nodes_[f].ref_==0 && f>1) {
+            release_node(f);
+        }
+    }
+    /*! The topmost variable of f and g */
+    std::uint32_t top_var(const bdd_node f, const bdd_node g) const {
+        std::uint32_t vf=nodes_[f].var_, vg=nodes_[g].var_;
+        return (level_[vf]<=level_[vg] ? vf : vg);
+    }
+    /*! The cofactor of f for the variable v, which is not below the top variable of f */
+    bdd_node cofactor(const bdd_node f, const std::uint32_t v, const bool value) const {
+        if (nodes_[f].var_!=v) {
+            return f;
+        }
+        return (value ? nodes_[f].hi_ : nodes_[f].lo_);
+    }
+    /*! The computed cache */
+    size_t cache_slot(const std::uint32_t op, const bdd_node a, const bdd_node b, const bdd_node c) const {
+        std::uint64_t h=(std::uint64_t(a)*0x9E3779B97F4A7C15ULL) ^ (std::uint64_t(b)*0xC2B2AE3D27D4EB4FULL) ^ (std::uint64_t(c)*0x165667B19E3779F9ULL) ^ op;
+        h^=(h>>29);
+        return size_t(h & (cache_.size()-1));
+    }
+    bool cache_lookup(const std::uint32_t op, const bdd_node a, const bdd_node b, const bdd_node c, bdd_node& r) const {
+        const CacheEntry& e=cache_[cache_slot(op,a,b,c)];
+        if (e.op_==op && e.a_==a && e.b_==b && e.c_==c) {
+            r=e.r_;
+            return true;
+        }
+        return false;
+    }
+    void cache_insert(const std::uint32_t op, const bdd_node a, const bdd_node b, const bdd_node c, const bdd_node r) {
+        cache_[cache_slot(op,a,b,c)]=CacheEntry{op,a,b,c,r};
+    }
+    void clear_cache() {
+        std::fill(cache_.begin(),cache_.end(),CacheEntry{0,0,0,0,0});
+    }
+    /*! Swap the variables at the levels l and l+1.
+     *
+     * The nodes of the upper variable x which have a child labeled with the lower variable y are rewritten in place into nodes of y, whose children are (possibly new) nodes of x; the other nodes of x simply move one level down. The nodes of y which are not referenced anymore are freed immediately, so that no_nodes_ stays exact. */
+    void swap_levels(const std::uint32_t l) {
+        std::uint32_t x=var_at_[l], y=var_at_[l+1];
+        std::vector<bdd_node> moving;
+        for (auto it=unique_[x].begin(); it!=unique_[x].end(); ++it) {
+            const Node& n=nodes_[it->second];
+            if (nodes_[n.lo_].var_==y || nodes_[n.hi_].var_==y) {
+                moving.push_back(it->second);
+            }
+        }
+        for (size_t m=0; m<moving.size(); m++) {
+            const Node& n=nodes_[moving[m]];
+            unique_[x].erase((std::uint64_t(n.lo_)<<32) | n.hi_);
+        }
+        var_at_[l]=y;
+        var_at_[l+1]=x;
+        level_[y]=l;
+        level_[x]=l+1;
+        for (size_t m=0; m<moving.size(); m++) {
+            bdd_node f=moving[m];
+            bdd_node f0=nodes_[f].lo_, f1=nodes_[f].hi_;
+            bdd_node f00=f0, f01=f0, f10=f1, f11=f1;
+            if (nodes_[f0].var_==y) {
+                f00=nodes_[f0].lo_;
+                f01=nodes_[f0].hi_;
+            }
+            if (nodes_[f1].var_==y) {
+                f10=nodes_[f1].lo_;
+                f11=nodes_[f1].hi_;
+            }
+            bdd_node lo=mk(x,f00,f10);
+            nodes_[lo].ref_++;
+            bdd_node hi=mk(x,f01,f11);
+            nodes_[hi].ref_++;
+            nodes_[f].var_=y;
+            nodes_[f].lo_=lo;
+            nodes_[f].hi_=hi;
+            unique_[y][(std::uint64_t(lo)<<32) | hi]=f;
+            deref_node(f0);
+            deref_node(f1);
+        }
+    }
+    /*! Move the variable v through all the levels, and leave it at the level where the table was smallest */
+    void sift(const std::uint32_t v) {
+        std::uint32_t l=level_[v];
+        std::uint32_t best_level=l;
+        size_t best_size=no_nodes_;
+        /* first towards the closer end, then towards the other end */
+        bool down_first=(no_vars_-1-l<l);
+        for (int pass=0; pass<2; pass++) {
+            bool down=(pass==0 ? down_first : !down_first);
+            while (down ? l+1<no_vars_ : l>0) {
+                if (down) {
+                    swap_levels(l);
+                    l++;
+                } else {
+                    swap_levels(l-1);
+                    l--;
+                }
+                if (no_nodes_<best_size) {
+                    best_size=no_nodes_;
+                    best_level=l;
+                }
+                if (no_nodes_>max_growth_*best_size) {
+                    break;
+                }
+            }
+        }
+        while (l<best_level) {
+            swap_levels(l);
+            l++;
+        }
+        while (l>best_level) {
+            swap_levels(l-1);
+            l--;
+        }
+    }
+};/* end of class definition */
+
+/**
+ *  @class Bdd
+ *
+ *  @brief A handle to a BDD node, which keeps the node referenced. The manager must outlive the handles.
+ */
+class Bdd {
+private:
+    /** @brief the manager **/
+    BddManager* manager_;
+    /** @brief the node **/
+    bdd_node node_;
+public:
+    /*! Default constructor: the constant false without a manager */
+    Bdd() : manager_(nullptr), node_(0) {}
+    /*! Constructor
+     * \param[in] manager   the manager
+     * \param[in] node      the node, which gets referenced */
+    Bdd(BddManager* manager, const bdd_node node) : manager_(manager), node_(node) {
+        if (manager_) {
+            manager_->ref(node_);
+        }
+    }
+    Bdd(const Bdd& other) : manager_(other.manager_), node_(other.node_) {
+        if (manager_) {
+            manager_->ref(node_);
+        }
+    }
+    Bdd(Bdd&& other) noexcept : manager_(other.manager_), node_(other.node_) {
+        other.manager_=nullptr;
+    }
+    Bdd& operator=(const Bdd& other) {
+        if (other.manager_) {
+            other.manager_->ref(other.node_);
+        }
+        if (manager_) {
+            manager_->deref(node_);
+        }
+        manager_=other.manager_;
+        node_=other.node_;
+        return *this;
+    }
+    Bdd& operator=(Bdd&& other) noexcept {
+        if (this!=&other) {
+            if (manager_) {
+                manager_->deref(node_);
+            }
+            manager_=other.manager_;
+            node_=other.node_;
+            other.manager_=nullptr;
+        }
+        return *this;
+    }
+    ~Bdd() {
+        if (manager_) {
+            manager_->deref(node_);
+        }
+    }
+    /*! The node */
+    bdd_node node() const {
+        return node_;
+    }
+    /*! The manager */
+    BddManager* manager() const {
+        return manager_;
+    }
+    bool is_zero() const {
+        return node_==0;
+    }
+    bool is_one() const {
+        return node_==1;
+    }
+    bool operator==(const Bdd& other) const {
+        return node_==other.node_;
+    }
+    bool operator!=(const Bdd& other) const {
+        return node_!=other.node_;
+    }
+    Bdd operator&(const Bdd& other) const {
+        manager_->checkpoint();
+        return Bdd(manager_,manager_->apply_and(node_,other.node_));
+    }
+    Bdd operator|(const Bdd& other) const {
+        manager_->checkpoint();
+        return Bdd(manager_,manager_->apply_or(node_,other.node_));
+    }
+    Bdd operator^(const Bdd& other) const {
+        manager_->checkpoint();
+        return Bdd(manager_,manager_->apply_xor(node_,other.node_));
+    }
+    Bdd operator!() const {
+        manager_->checkpoint();
+        return Bdd(manager_,manager_->apply_not(node_));
+    }
+    Bdd& operator&=(const Bdd& other) {
+        return (*this=*this & other);
+    }
+    Bdd& operator|=(const Bdd& other) {
+        return (*this=*this | other);
+    }
+    /*! If this then g else h */
+    Bdd ite(const Bdd& g, const Bdd& h) const {
+        manager_->checkpoint();
+        return Bdd(manager_,manager_->apply_ite(node_,g.node_,h.node_));
+    }
+    /*! Existential quantification over the variables of the cube */
+    Bdd exists(const Bdd& cube) const {
+        manager_->checkpoint();
+        return Bdd(manager_,manager_->apply_exists(node_,cube.node_));
+    }
+    /*! Universal quantification over the variables of the cube */
+    Bdd forall(const Bdd& cube) const {
+        return !((!*this).exists(cube));
+    }
+    /*! Existential quantification over the variables of the cube of the conjunction with g */
+    Bdd and_exists(const Bdd& g, const Bdd& cube) const {
+        manager_->checkpoint();
+        return Bdd(manager_,manager_->apply_and_exists(node_,g.node_,cube.node_));
+    }
+    /*! Rename the variables: the variable v becomes perm[v] */
+    Bdd permute(const std::vector<std::uint32_t>& perm) const {
+        manager_->checkpoint();
+        std::unordered_map<bdd_node,bdd_node> memo;
+        return Bdd(manager_,manager_->apply_permute(node_,perm,memo));
+    }
+    /*! Whether the assignment (indexed by the variables) satisfies the function */
+    bool evaluate(const std::vector<bool>& assignment) const {
+        return manager_->evaluate(node_,assignment);
+    }
+};/* end of class definition */
+
+inline Bdd BddManager::zero() {
+    return Bdd(this,0);
+}
+inline Bdd BddManager::one() {
+    return Bdd(this,1);
+}
+inline Bdd BddManager::var(const std::uint32_t v) {
+    return Bdd(this,var_node(v));
+}
+inline Bdd BddManager::nvar(const std::uint32_t v) {
+    return Bdd(this,mk(v,1,0));
+}
+inline Bdd BddManager::cube(const std::vector<std::uint32_t>& vars) {
+    Bdd c=one();
+    for (size_t n=0; n<vars.size(); n++) {
+        c&=var(vars[n]);
+    }
+    return c;
+}
+inline Bdd BddManager::encode(const std::vector<std::uint32_t>& vars, std::uint64_t value) {
+    Bdd c=one();
+    for (size_t n=0; n<vars.size(); n++) {
+        c&=(((value>>n) & 1) ? var(vars[n]) : nvar(vars[n]));
+    }
+    return c;
+}
+
+}/* end of namespace negotiation */
+#endif
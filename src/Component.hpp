@@ -10,6 +10,12 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <map>
+#include <queue>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <initializer_list>
 
 #include "FileHandler.hpp"
 #include "DotInterface.hpp"
@@ -25,12 +31,59 @@ using abs_type=std::uint32_t;
 
 /**
  * @brief abs_ptr_type defines type used to point to the array m_pre (default = uint64_t) \n
- * determinse implicitely an upper bound on the number of transitions (default = * 2^64-1)
+ * determinse implicitely an upper bound on the number of transitions (default = * 2^64-1) \n
+ * all the addresses of state-input pairs in the transition arrays (see Component::addr, SafetyAutomaton::addr, Monitor::addr_xuw) are of this type, so that they do not overflow when the number of pairs exceeds the range of abs_type
  **/
 using abs_ptr_type=std::uint64_t;
 
+/*! Product of sizes, checked for overflow where a model is sized.
+ * \param[in] factors   the sizes
+ * \param[in] bound     the largest admissible product (e.g. the largest index of the type used for it)
+ * \param[in] what      what the product counts, for the error message
+ * \param[out] p        the product
+ * \throw std::overflow_error if the product exceeds bound */
+inline abs_ptr_type checked_product(std::initializer_list<abs_ptr_type> factors, const abs_ptr_type bound, const std::string& what) {
+    abs_ptr_type p=1;
+    for (auto f=factors.begin(); f!=factors.end(); ++f) {
+        if (*f!=0 && p>bound/(*f)) {
+            throw std::overflow_error(what+" exceeds the range of the index type ("+std::to_string(bound)+").");
+        }
+        p*=*f;
+    }
+    if (p>bound) {
+        throw std::overflow_error(what+" exceeds the range of the index type ("+std::to_string(bound)+").");
+    }
+    return p;
+}
+
 using namespace std;
 
+/*! Partition a set of elements into the classes of elements with equal keys.
+ * \param[in] keys     vector containing the key of each element
+ * \param[out] cls     vector containing the class of each element; the classes are numbered in the order of their smallest elements */
+template<class Key>
+std::vector<abs_type> classes_of_equal_keys(const std::vector<Key>& keys) {
+    std::map<Key,abs_type> class_of_key;
+    std::vector<abs_type> cls;
+    for (size_t l=0; l<keys.size(); l++) {
+        auto it=class_of_key.insert(std::make_pair(keys[l],abs_type(class_of_key.size()))).first;
+        cls.push_back(it->second);
+    }
+    return cls;
+}
+/*! The smallest element of every class of a partition (as computed by classes_of_equal_keys).
+ * \param[in] cls      vector containing the class of each element
+ * \param[out] reps    vector containing the smallest element of each class */
+inline std::vector<abs_type> class_representatives(const std::vector<abs_type>& cls) {
+    std::vector<abs_type> reps;
+    for (size_t l=0; l<cls.size(); l++) {
+        if (cls[l]==reps.size()) {
+            reps.push_back(l);
+        }
+    }
+    return reps;
+}
+
 /**
  *  @class Component
  *
@@ -53,7 +106,7 @@ public:
     abs_type no_outputs;
     /** @brief vector[N] containing the output mapping **/
     std::vector<abs_type> state_to_output;
-    /** @brief vector[R] containing the state indices **/
+    /** @brief vector[R] containing the state indices (the number of states N for an output which no state has) **/
     std::vector<abs_type> output_to_state;
     /** @brief post array: the index ( i*M*P + j*P + k ) holds the list of post states for the (state,control,disturbance,post_state)  tuple (i,j,k), where i, j, k start from 0,..**/
     std::vector<abs_type>** post;
@@ -67,18 +120,75 @@ public:
         no_outputs=other.no_outputs;
         state_to_output=other.state_to_output;
         output_to_state=other.output_to_state;
-        abs_type size = no_states*no_control_inputs*no_dist_inputs;
+        abs_ptr_type size = abs_ptr_type(no_states)*no_control_inputs*no_dist_inputs;
         post = new std::vector<abs_type>*[size];
-        for (abs_type i=0; i<size; i++) {
-            post[i]=other.post[i];
+        for (abs_ptr_type i=0; i<size; i++) {
+            post[i]=new std::vector<abs_type>(*other.post[i]);
+        }
+    }
+    /*! Constructor: restriction of a component to a subset of its inputs
+     * \param[in] other             the component to be restricted
+     * \param[in] control_inputs    the control inputs of other which are kept (control input j is control input control_inputs[j] of other)
+     * \param[in] dist_inputs       the disturbance inputs of other which are kept (disturbance input k is disturbance input dist_inputs[k] of other) */
+    Component(Component& other, const std::vector<abs_type>& control_inputs, const std::vector<abs_type>& dist_inputs) {
+        no_states=other.no_states;
+        init_=other.init_;
+        no_control_inputs=control_inputs.size();
+        no_dist_inputs=dist_inputs.size();
+        no_outputs=other.no_outputs;
+        state_to_output=other.state_to_output;
+        output_to_state=other.output_to_state;
+        post = new std::vector<abs_type>*[abs_ptr_type(no_states)*no_control_inputs*no_dist_inputs];
+        for (abs_type i=0; i<no_states; i++) {
+            for (abs_type j=0; j<no_control_inputs; j++) {
+                for (abs_type k=0; k<no_dist_inputs; k++) {
+                    post[addr(i,j,k)]=new std::vector<abs_type>(*other.post[other.addr(i,control_inputs[j],dist_inputs[k])]);
+                }
+            }
+        }
+    }
+    /*! Constructor: quotient of a component with respect to a partition of its states (usually computed by bisimulation_classes)
+     *
+     * The transitions of every class are those of its smallest state, with the post states replaced by their classes.
+     * \param[in] other         the component
+     * \param[in] state_class   vector[N] containing the class of each state of other (see classes_of_equal_keys) */
+    Component(Component& other, const std::vector<abs_type>& state_class) {
+        std::vector<abs_type> reps=class_representatives(state_class);
+        no_states=reps.size();
+        for (auto i=other.init_.begin(); i!=other.init_.end(); ++i) {
+            init_.insert(state_class[*i]);
+        }
+        no_control_inputs=other.no_control_inputs;
+        no_dist_inputs=other.no_dist_inputs;
+        no_outputs=other.no_outputs;
+        for (abs_type i=0; i<no_states; i++) {
+            state_to_output.push_back(other.state_to_output[reps[i]]);
+        }
+        for (size_t o=0; o<other.output_to_state.size(); o++) {
+            output_to_state.push_back(state_class[other.output_to_state[o]]);
+        }
+        post = new std::vector<abs_type>*[abs_ptr_type(no_states)*no_control_inputs*no_dist_inputs];
+        for (abs_type i=0; i<no_states; i++) {
+            for (abs_type j=0; j<no_control_inputs; j++) {
+                for (abs_type k=0; k<no_dist_inputs; k++) {
+                    std::vector<abs_type>* v=new std::vector<abs_type>;
+                    for (auto i2=other.post[other.addr(reps[i],j,k)]->begin(); i2!=other.post[other.addr(reps[i],j,k)]->end(); ++i2) {
+                        v->push_back(state_class[*i2]);
+                    }
+                    std::sort(v->begin(),v->end());
+                    v->erase(std::unique(v->begin(),v->end()),v->end());
+                    post[addr(i,j,k)]=v;
+                }
+            }
         }
     }
     /*! The destructor */
     ~Component() {
-        abs_type no_elems = no_states*no_control_inputs*no_dist_inputs;
-        for (abs_type i=0; i<no_elems; i++) {
+        abs_ptr_type no_elems = abs_ptr_type(no_states)*no_control_inputs*no_dist_inputs;
+        for (abs_ptr_type i=0; i<no_elems; i++) {
             delete post[i];
         }
+        delete[] post;
     }
     /* @endcond */
     /*!
@@ -108,7 +218,7 @@ public:
         for (size_t i=0; i<no_states; i++) {
             output_to_state[state_to_output[i]]=i;
         }
-        abs_type no_post_elems = no_states*no_control_inputs*no_dist_inputs;
+        abs_ptr_type no_post_elems = checked_product({no_states,no_control_inputs,no_dist_inputs},std::numeric_limits<size_t>::max()/sizeof(std::vector<abs_type>*),"Component: the number of state-input pairs");
         post = new std::vector<abs_type>*[no_post_elems];
         for (size_t i=0; i<no_post_elems; i++) {
             std::vector<abs_type> *v = new std::vector<abs_type>;
@@ -121,8 +231,8 @@ public:
      * \param[in] j           control input index
      * \param[in] k           disturbance input index
      * \param[out] ind    address of the post state vector in post **/
-    inline int addr(const abs_type i, const abs_type j, const abs_type k) {
-        return (i*no_control_inputs*no_dist_inputs + j*no_dist_inputs + k);
+    inline abs_ptr_type addr(const abs_type i, const abs_type j, const abs_type k) {
+        return (abs_ptr_type(i)*no_control_inputs*no_dist_inputs + abs_ptr_type(j)*no_dist_inputs + k);
     }
     /*! Index of the control input from a joint control-disturbance index.
      * \param[in] l             joint control-disturbance input index
@@ -130,6 +240,145 @@ public:
     inline abs_type cont_ind(const abs_type l) {
         return (l / no_dist_inputs);
     }
+    /*! Trim the part of the component which is unreachable from the initial states under any inputs.
+     *  The remaining states keep their relative order.
+     * \param[out] old_to_new   vector[N] (N being the old number of states) containing the new index of each old state, or the new number of states for the removed states */
+    std::vector<abs_type> trim() {
+        /* compute the set of reachable states */
+        std::vector<bool> seen(no_states,false);
+        std::queue<abs_type> fifo;
+        for (auto i=init_.begin(); i!=init_.end(); ++i) {
+            fifo.push(*i);
+            seen[*i]=true;
+        }
+        while (fifo.size()!=0) {
+            abs_type i=fifo.front();
+            fifo.pop();
+            for (abs_type j=0; j<no_control_inputs; j++) {
+                for (abs_type k=0; k<no_dist_inputs; k++) {
+                    for (auto i2=post[addr(i,j,k)]->begin(); i2!=post[addr(i,j,k)]->end(); ++i2) {
+                        if (!seen[*i2]) {
+                            fifo.push(*i2);
+                            seen[*i2]=true;
+                        }
+                    }
+                }
+            }
+        }
+        /* number the reachable states in increasing order */
+        std::vector<abs_type> new_to_old;
+        for (abs_type i=0; i<no_states; i++) {
+            if (seen[i]) {
+                new_to_old.push_back(i);
+            }
+        }
+        std::vector<abs_type> old_to_new(no_states,new_to_old.size());
+        for (abs_type i_new=0; i_new<new_to_old.size(); i_new++) {
+            old_to_new[new_to_old[i_new]]=i_new;
+        }
+        if (new_to_old.size()==no_states) {
+            return old_to_new;
+        }
+        /* update the initial states and the outputs */
+        std::unordered_set<abs_type> init_old=init_;
+        init_.clear();
+        for (auto i=init_old.begin(); i!=init_old.end(); ++i) {
+            init_.insert(old_to_new[*i]);
+        }
+        std::vector<abs_type> state_to_output_old=state_to_output;
+        state_to_output.clear();
+        for (abs_type i_new=0; i_new<new_to_old.size(); i_new++) {
+            state_to_output.push_back(state_to_output_old[new_to_old[i_new]]);
+        }
+        if (output_to_state.size()!=0) {
+            /* the outputs whose states were all removed no longer map to any state */
+            output_to_state.assign(output_to_state.size(),new_to_old.size());
+            for (abs_type i_new=0; i_new<new_to_old.size(); i_new++) {
+                output_to_state[state_to_output[i_new]]=i_new;
+            }
+        }
+        /* update the post array: the posts of the reachable states are moved over, and the rest is freed */
+        abs_type no_states_old=no_states;
+        std::vector<abs_type>** post_old=post;
+        no_states=new_to_old.size();
+        post = new std::vector<abs_type>*[abs_ptr_type(no_states)*no_control_inputs*no_dist_inputs];
+        for (abs_type i_old=0; i_old<no_states_old; i_old++) {
+            for (abs_type j=0; j<no_control_inputs; j++) {
+                for (abs_type k=0; k<no_dist_inputs; k++) {
+                    std::vector<abs_type>* v=post_old[addr(i_old,j,k)];
+                    if (!seen[i_old]) {
+                        delete v;
+                        continue;
+                    }
+                    for (size_t l=0; l<v->size(); l++) {
+                        (*v)[l]=old_to_new[(*v)[l]];
+                    }
+                    post[addr(old_to_new[i_old],j,k)]=v;
+                }
+            }
+        }
+        delete[] post_old;
+        return old_to_new;
+    }
+    /*! Partition the control inputs into the classes of inputs which have identical transitions for every state and every disturbance input.
+     * \param[out] cls     vector[M] containing the class of each control input (see classes_of_equal_keys) */
+    std::vector<abs_type> control_input_classes() {
+        std::vector<std::vector<abs_type>> keys(no_control_inputs);
+        for (abs_type j=0; j<no_control_inputs; j++) {
+            for (abs_type i=0; i<no_states; i++) {
+                for (abs_type k=0; k<no_dist_inputs; k++) {
+                    append_sorted_post(addr(i,j,k),keys[j]);
+                }
+            }
+        }
+        return classes_of_equal_keys(keys);
+    }
+    /*! Partition the disturbance inputs into the classes of inputs which have identical transitions for every state and every control input.
+     * \param[out] cls     vector[P] containing the class of each disturbance input (see classes_of_equal_keys) */
+    std::vector<abs_type> dist_input_classes() {
+        std::vector<std::vector<abs_type>> keys(no_dist_inputs);
+        for (abs_type k=0; k<no_dist_inputs; k++) {
+            for (abs_type i=0; i<no_states; i++) {
+                for (abs_type j=0; j<no_control_inputs; j++) {
+                    append_sorted_post(addr(i,j,k),keys[k]);
+                }
+            }
+        }
+        return classes_of_equal_keys(keys);
+    }
+    /*! Partition the states into the classes of the coarsest bisimulation which refines a given partition: two states are in the same class if they are in the same class of the initial partition, and for every control and disturbance input they have post states in the same classes.
+     * \param[in] initial_class     vector[N] containing the class of each state in the initial partition (for example, the output and the membership in the safe and the target states)
+     * \param[out] cls              vector[N] containing the class of each state (see classes_of_equal_keys) */
+    std::vector<abs_type> bisimulation_classes(const std::vector<abs_type>& initial_class) {
+        std::vector<abs_type> cls=classes_of_equal_keys(initial_class);
+        abs_type no_classes=class_representatives(cls).size();
+        while (1) {
+            /* the key of a state: its current class, and the sorted classes of its post states for every input pair */
+            std::vector<std::vector<abs_type>> keys(no_states);
+            for (abs_type i=0; i<no_states; i++) {
+                keys[i].push_back(cls[i]);
+                for (abs_type j=0; j<no_control_inputs; j++) {
+                    for (abs_type k=0; k<no_dist_inputs; k++) {
+                        std::vector<abs_type> p;
+                        for (auto i2=post[addr(i,j,k)]->begin(); i2!=post[addr(i,j,k)]->end(); ++i2) {
+                            p.push_back(cls[*i2]);
+                        }
+                        std::sort(p.begin(),p.end());
+                        p.erase(std::unique(p.begin(),p.end()),p.end());
+                        keys[i].push_back(p.size());
+                        keys[i].insert(keys[i].end(),p.begin(),p.end());
+                    }
+                }
+            }
+            cls=classes_of_equal_keys(keys);
+            abs_type no_classes_new=class_representatives(cls).size();
+            /* the partition is stable when no class was split */
+            if (no_classes_new==no_classes) {
+                return cls;
+            }
+            no_classes=no_classes_new;
+        }
+    }
     /*! Save the description of the safety automaton as a directed graph with clusterd vertices
      * \param[in] filename      the output file name
      * \param[in] graph_name  the name of the graph
@@ -187,12 +436,12 @@ public:
             }
         }
         /* the address of the post vector in the "transitions" array is determined using the following lambda expression */
-        auto post_addr = [&](abs_type x, abs_type u, abs_type w) -> abs_type {
-            return (x*(no_control_inputs+1)*(no_dist_inputs+1) + u*(no_dist_inputs+1) + w);
+        auto post_addr = [&](abs_type x, abs_type u, abs_type w) -> abs_ptr_type {
+            return (abs_ptr_type(x)*(no_control_inputs+1)*(no_dist_inputs+1) + abs_ptr_type(u)*(no_dist_inputs+1) + w);
         };
         /* create a post array */
-        std::unordered_set<abs_type>** post_array=new std::unordered_set<abs_type>*[no_states*(no_control_inputs+1)*(no_dist_inputs+1)];
-        for (abs_type i=0; i<no_states*(no_control_inputs+1)*(no_dist_inputs+1); i++) {
+        std::unordered_set<abs_type>** post_array=new std::unordered_set<abs_type>*[abs_ptr_type(no_states)*(no_control_inputs+1)*(no_dist_inputs+1)];
+        for (abs_ptr_type i=0; i<abs_ptr_type(no_states)*(no_control_inputs+1)*(no_dist_inputs+1); i++) {
             std::unordered_set<abs_type>* set=new std::unordered_set<abs_type>;
             post_array[i]=set;
         }
@@ -284,6 +533,15 @@ public:
         createDOT(filename, graph_name, state_labels, state_clusters, control_input_labels, dist_input_labels);
     }
 private:
+    /*! Append the number of post states and the sorted post states of a state-input triple to a key (used for comparing the effects of inputs)
+     * \param[in] l     address of the triple in post
+     * \param[in] key   the key */
+    void append_sorted_post(const abs_ptr_type l, std::vector<abs_type>& key) {
+        std::vector<abs_type> p=*post[l];
+        std::sort(p.begin(),p.end());
+        key.push_back(p.size());
+        key.insert(key.end(),p.begin(),p.end());
+    }
     /*! Compute union of two vectors
      * \param[in] v1  the first vector
      * \param[in] v2  the second vector
@@ -0,0 +1,172 @@
+/* ContractCache.hpp
+ *
+ *  Date: 19/10/2026 */
+
+/** @file **/
+#ifndef CONTRACTCACHE_HPP_
+#define CONTRACTCACHE_HPP_
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <atomic>
+#include <cstdio>
+#include <unistd.h>
+
+#include "SafetyAutomaton.hpp"
+
+/** @namespace negotiation **/
+namespace negotiation {
+
+/**
+ *  @class ContractCache
+ *
+ *  @brief A persistent on-disk cache of the outcomes of negotiations.
+ *
+ *  Every entry is stored in its own binary file in the cache directory. The name of the file is derived from a content hash of the input files (the components and their safe and target states) together with the search parameters (the kind of search, the depth, and the starting component) and version_, and it contains the outcome of the search together with the final pair of guarantees. Entries written by another version are never served: they are stored under other names, and their headers do not match. Entries are written to a temporary file first and then atomically renamed, so that several processes can share the same cache directory.
+ */
+class ContractCache {
+public:
+    /** @brief the cache directory **/
+    std::string dir_;
+private:
+    /** @brief identifies the file format **/
+    static constexpr std::uint64_t magic_=0x3143434e53454e47ULL;
+    /** @brief the version of the solver and of the file format, which has to be increased whenever a change of either may change the cached outcomes or guarantees **/
+    static constexpr std::uint32_t version_=1;
+public:
+    /*! Constructor
+     * \param[in] dir       the cache directory (created if it does not exist) */
+    ContractCache(const std::string& dir) : dir_(dir) {
+        checkMakeDir(dir_.c_str());
+    }
+    /*! Content hash of a list of files (FNV-1a over the lengths and the contents of the files)
+     * \param[in] filenames     the names of the files
+     * \param[out] h                    the hash */
+    static std::uint64_t hashFiles(const std::vector<std::string>& filenames) {
+        std::uint64_t h=14695981039346656037ULL;
+        auto mix = [&](const char* data, size_t n) {
+            for (size_t i=0; i<n; i++) {
+                h^=static_cast<unsigned char>(data[i]);
+                h*=1099511628211ULL;
+            }
+        };
+        for (size_t f=0; f<filenames.size(); f++) {
+            std::ifstream file(filenames[f], std::ios::in | std::ios::binary);
+            std::stringstream content;
+            content << file.rdbuf();
+            std::string str=content.str();
+            std::uint64_t n=str.size();
+            mix(reinterpret_cast<const char*>(&n),sizeof(n));
+            mix(str.data(),str.size());
+        }
+        return h;
+    }
+    /*! Look up an entry.
+     * \param[in] input_hash    the content hash of the input files
+     * \param[in] params            the search parameters
+     * \param[in] outcome           the cached outcome of the search
+     * \param[in] guarantee      the vector of guarantees, which are overwritten by the cached ones
+     * \param[out] hit                true if the entry was found and could be read, false otherwise */
+    bool lookup(const std::uint64_t input_hash, const std::vector<int>& params, int& outcome, std::vector<SafetyAutomaton*>& guarantee) {
+        std::ifstream file(entryName(input_hash,params), std::ios::in | std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        std::uint64_t m, h;
+        std::uint32_t v;
+        std::int32_t n_params;
+        file.read(reinterpret_cast<char*>(&m),sizeof(m));
+        file.read(reinterpret_cast<char*>(&v),sizeof(v));
+        file.read(reinterpret_cast<char*>(&h),sizeof(h));
+        file.read(reinterpret_cast<char*>(&n_params),sizeof(n_params));
+        if (!file || m!=magic_ || v!=version_ || h!=input_hash || n_params!=static_cast<std::int32_t>(params.size())) {
+            return false;
+        }
+        for (size_t i=0; i<params.size(); i++) {
+            std::int32_t p;
+            file.read(reinterpret_cast<char*>(&p),sizeof(p));
+            if (!file || p!=params[i]) {
+                return false;
+            }
+        }
+        std::int32_t o;
+        file.read(reinterpret_cast<char*>(&o),sizeof(o));
+        if (!file) {
+            return false;
+        }
+        std::vector<SafetyAutomaton*> g;
+        for (size_t c=0; c<guarantee.size(); c++) {
+            SafetyAutomaton* s=new SafetyAutomaton();
+            g.push_back(s);
+            if (!s->readBinary(file)) {
+                for (size_t i=0; i<g.size(); i++) {
+                    delete g[i];
+                }
+                return false;
+            }
+        }
+        outcome=o;
+        for (size_t c=0; c<guarantee.size(); c++) {
+            delete guarantee[c];
+        }
+        guarantee=g;
+        return true;
+    }
+    /*! Store an entry.
+     * \param[in] input_hash    the content hash of the input files
+     * \param[in] params            the search parameters
+     * \param[in] outcome           the outcome of the search
+     * \param[in] guarantee      the vector of guarantees */
+    void store(const std::uint64_t input_hash, const std::vector<int>& params, const int outcome, const std::vector<SafetyAutomaton*>& guarantee) {
+        static std::atomic<unsigned> counter(0);
+        std::string name=entryName(input_hash,params);
+        std::string tmp_name=name+".tmp."+std::to_string(getpid())+"."+std::to_string(counter++);
+        std::ofstream file(tmp_name, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return;
+        }
+        std::uint64_t m=magic_;
+        std::uint32_t v=version_;
+        std::int32_t n_params=params.size();
+        file.write(reinterpret_cast<const char*>(&m),sizeof(m));
+        file.write(reinterpret_cast<const char*>(&v),sizeof(v));
+        file.write(reinterpret_cast<const char*>(&input_hash),sizeof(input_hash));
+        file.write(reinterpret_cast<const char*>(&n_params),sizeof(n_params));
+        for (size_t i=0; i<params.size(); i++) {
+            std::int32_t p=params[i];
+            file.write(reinterpret_cast<const char*>(&p),sizeof(p));
+        }
+        std::int32_t o=outcome;
+        file.write(reinterpret_cast<const char*>(&o),sizeof(o));
+        for (size_t c=0; c<guarantee.size(); c++) {
+            guarantee[c]->writeBinary(file);
+        }
+        file.close();
+        if (!file || std::rename(tmp_name.c_str(),name.c_str())!=0) {
+            std::remove(tmp_name.c_str());
+        }
+    }
+private:
+    /*! The file name of an entry (a hash of the input hash, the version and the parameters) */
+    std::string entryName(const std::uint64_t input_hash, const std::vector<int>& params) {
+        std::uint64_t h=input_hash;
+        auto mix = [&](const std::uint32_t p) {
+            for (int b=0; b<4; b++) {
+                h^=(p>>(8*b)) & 0xff;
+                h*=1099511628211ULL;
+            }
+        };
+        mix(version_);
+        for (size_t i=0; i<params.size(); i++) {
+            mix(params[i]);
+        }
+        std::ostringstream name;
+        name << dir_ << "/" << std::hex << std::setw(16) << std::setfill('0') << h << ".contract";
+        return name.str();
+    }
+};/* end of class definition */
+}/* end of namespace negotiation */
+#endif
@@ -691,8 +691,8 @@ void writeArrVec(const std::string& filename, const std::string& arr_name, std::
  * \param[in] arr_name     The name of the array
  * \param[in] arr                 The array
  * \param[in] mode                [Optional] The writing mode: "a" for append, "w" for write/overwrite. Default="a".*/
-template<class T>
-void writeArrSet(const std::string& filename, const std::string& arr_name, std::unordered_set<T>** arr, size_t no_elem, const char* mode="a") {
+template<class T, class H, class E, class A>
+void writeArrSet(const std::string& filename, const std::string& arr_name, std::unordered_set<T,H,E,A>** arr, size_t no_elem, const char* mode="a") {
     std::ofstream file;
     if (!strcmp(mode,"a")) {
         file.open(filename, std::ios_base::app);
@@ -10,8 +10,11 @@
 #include <vector>
 #include <queue>
 #include <limits>
+#include <algorithm>
+#include <cstdint>
 
 #include "Component.hpp" /* for the definition of data types abs_type and abs_ptr_type */
+#include "Attractor.hpp"
 
 /** @namespace negotiation **/
 namespace negotiation {
@@ -35,14 +38,16 @@ public:
      * \param[in] component_target_states   set of component target states
      * \param[in] allowed_control_inputs    vector of allowed control inputs indexed using the monitor state indices
      * \param[in] allowed_joint_inputs      vector of allowed joint action inputs indexed using the monitor state indices
+     * \param[in] arena                     [Optional] the arena to allocate from (a new one is created by default)
 
      * NOTE: allowed_joint_inputs[i] has any effect only when allowed_control_inputs[i] is empty. */
     LivenessGame(Component& comp,
                  SafetyAutomaton& assume,
                  SafetyAutomaton& guarantee,
                  const std::unordered_set<abs_type> component_target_states,
-                 std::vector<std::unordered_set<abs_type>*> allowed_control_inputs,
-                 std::vector<std::unordered_set<abs_type>*> allowed_joint_inputs) : Monitor(comp, assume, guarantee, allowed_control_inputs, allowed_joint_inputs) {
+                 std::vector<arena_set*> allowed_control_inputs,
+                 std::vector<arena_set*> allowed_joint_inputs,
+                 std::shared_ptr<Arena> arena=std::shared_ptr<Arena>()) : Monitor(comp, assume, guarantee, allowed_control_inputs, allowed_joint_inputs, arena) {
         /* target states */
         /* the assumption violation is always in target */
         monitor_target_states_.insert(0);
@@ -68,8 +73,8 @@ public:
      * NOTE: allowed_joint_inputs[i] has any effect only when allowed_control_inputs[i] is empty. */
     LivenessGame(const Monitor& monitor_other,
                 const std::unordered_set<abs_type> component_target_states,
-                std::vector<std::unordered_set<abs_type>*> allowed_control_inputs,
-                std::vector<std::unordered_set<abs_type>*> allowed_joint_inputs) : Monitor(monitor_other) {
+                std::vector<arena_set*> allowed_control_inputs,
+                std::vector<arena_set*> allowed_joint_inputs) : Monitor(monitor_other) {
 
         /* sanity check */
         if (allowed_control_inputs.size()!=no_states
@@ -87,12 +92,7 @@ public:
                 for (abs_type k=0; k<no_dist_inputs; k++) {
                     if ((bad_control_input) ||
                         (allowed_joint_inputs[im]->find(addr_uw(j,k))==allowed_joint_inputs[im]->end())) {
-                        abs_type addr_post=addr_xuw(im,j,k);
-                        for (auto im2=post[addr_post]->begin(); im2!=post[addr_post]->end(); ++im2) {
-                            pre[addr_xuw(*im2,j,k)]->erase(im);
-                        }
-                        post[addr_post]->clear();
-                        no_post[addr_post]=0;
+                        disable(addr_xuw(im,j,k));
                     }
                 }
             }
@@ -115,13 +115,9 @@ public:
     /*! Solve reach-avoid game, without any assumption on the disturbance inputs.
      \param[in] str                                                  string specifying the sure/maybe winning condition
      \param[out] D                                                    optimal state-input pairs */
-     std::vector<unordered_set<abs_type>*> solve_reach_avoid_game(const char* str) {
+     std::vector<arena_set*> solve_reach_avoid_game(const char* str) {
          /* create a set of empty friendly disturbances for each state */
-         std::vector<std::unordered_set<abs_type>*> friendly_dist;
-         for (abs_type i=0; i<no_states; i++) {
-             std::unordered_set<abs_type>* set = new std::unordered_set<abs_type>;
-             friendly_dist.push_back(set);
-         }
+         std::vector<arena_set*> friendly_dist=new_set_vector(no_states);
          return solve_reach_avoid_game(str, friendly_dist);
      }
     /*! Solve reach-avoid game, where the target is given by the local specification, and the "obstacle" is given by the reject_G (violation of guarantee) state.
@@ -132,137 +128,47 @@ public:
      * \param[in] str                                                  string specifying the sure/maybe winning condition
      * \param[in] friendly_dist                            disturbance inputs to ignore
      * \param[out] D                                                    optimal state-input pairs */
-    std::vector<unordered_set<abs_type>*> solve_reach_avoid_game(const char* str, std::vector<std::unordered_set<abs_type>*>& friendly_dist) {
+    std::vector<arena_set*> solve_reach_avoid_game(const char* str, std::vector<arena_set*>& friendly_dist) {
         /* sanity check */
-        if (!strcmp(str,"sure") && !strcmp(str,"maybe")) {
+        if (strcmp(str,"sure") && strcmp(str,"maybe")) {
             try {
                 throw std::runtime_error("Reach-avoid Game: invalid input.");
             } catch (std::exception& e) {
                 std::cout << e.what() << "\n";
             }
         }
-        /* a very high number used as value of losing states */
-        abs_type losing = std::numeric_limits<abs_type>::max();
-        /* FIFO queue */
-        std::queue<abs_type> Q;
-        for (auto i=monitor_target_states_.begin(); i!=monitor_target_states_.end(); ++i) {
-            Q.push(*i);
-        }
-        /* value function */
-        std::vector<abs_type> V;
-        /* intermediate values of the state input pairs */
-        std::vector<abs_type> M;
-        for (abs_type i=0; i<no_states; i++) {
-            for (abs_type j=0; j<no_control_inputs; j++) {
-                if (!strcmp(str,"sure")) { /* for sure winning, the values are associated with state-control input pairs*/
-                    M.push_back(0);
-                } else { /* for maybe winning, the values are associated with state-control input-disturbance input triples */
-                    for (abs_type k=0; k<no_dist_inputs; k++) {
-                        M.push_back(0);
-                    }
-                }
-            }
-        }
-        /* bookkeeping of processed states */
-        std::unordered_set<abs_type> E;
-        /* optimal inputs indexed by the state indices */
-        std::vector<std::unordered_set<abs_type>*> D;
-        /* initialize the values of the non-target states with "losing", and the optimal inputs of the target states with the input 0 (chosen arbitrarily, can be anything). */
-        for (abs_type i=0; i<no_states; i++) {
-            std::unordered_set<abs_type>* s=new std::unordered_set<abs_type>;
-            if (monitor_target_states_.find(i)!=monitor_target_states_.end()) { /* i is in target set */
-                V.push_back(0); /* value is 0 */
-                s->insert(0); /* any input is optimal, 0 is chosen arbitrarily */
-                D.push_back(s);
-            } else { /* i is not in target */
-                V.push_back(losing);
-                D.push_back(s);
-            }
-        }
-        /* keep track of the number of processed posts */
-        std::vector<abs_type> K;
-        for (abs_type i=0; i<no_states; i++) {
-            for (abs_type j=0; j<no_control_inputs; j++) {
-                abs_type np=0;
-                for (abs_type k=0; k<no_dist_inputs; k++) {
-                    if (!strcmp(str,"maybe")) {
-                        K.push_back(no_post[addr_xuw(i,j,k)]);
-                    } else {
-                        np+=no_post[addr_xuw(i,j,k)];
-                    }
-                }
-                if (!strcmp(str,"sure")) {
-                    K.push_back(np);
-                }
-            }
-        }
-        /* until the queue is empty */
-        while (Q.size()!=0) {
-            /* pop the oldest element */
-            abs_type x = Q.front();
-            Q.pop();
-            /* update the set of seen states */
-            E.insert(x);
-            for (abs_type j=0; j<no_control_inputs; j++) {
-                for (abs_type k=0; k<no_dist_inputs; k++) {
-                    abs_type x2 = addr_xuw(x,j,k);
-                    for (auto it=pre[x2]->begin(); it!=pre[x2]->end(); ++it) {
-                        /* if the pre state is in avoid, ignore */
-                        if (monitor_avoid_states_.find(*it)!=monitor_avoid_states_.end()) {
-                            continue;
-                        }
-                        if (!strcmp(str,"sure")) {
-                            /* if the current disturbance input is friendly, then all the non-deterministic posts are favorable, otherwise just one post (leading to x) is favorable */
-                            if (friendly_dist[*it]->find(k)!=friendly_dist[*it]->end()) {
-                                K[addr_xu(*it,j)]= K[addr_xu(*it,j)]- no_post[addr_xuw(*it,j,k)];
-                            } else {
-                                K[addr_xu(*it,j)]--;
-                            }
-                            M[addr_xu(*it,j)] = (M[addr_xu(*it,j)]>=1+V[x] ? M[addr_xu(*it,j)] : 1+V[x]);
-                            if (!K[addr_xu(*it,j)] && V[*it]>M[addr_xu(*it,j)]) {
-                                Q.push(*it);
-                                V[*it]=M[addr_xu(*it,j)];
-                                D[*it]->clear();
-                                D[*it]->insert(j);
-                            }
-                        } else {
-                            K[addr_xuw(*it,j,k)]--;
-                            M[addr_xuw(*it,j,k)] = (M[addr_xuw(*it,j,k)]>=1+V[x] ? M[addr_xuw(*it,j,k)] : 1+V[x]);
-                            if (!K[addr_xuw(*it,j,k)] && V[*it]>M[addr_xuw(*it,j,k)]) {
-                                Q.push(*it);
-                                V[*it]=M[addr_xuw(*it,j,k)];
-                                D[*it]->clear();
-                                D[*it]->insert(addr_uw(j,k));
-                            }
-                        }
-                    }
-                }
-            }
-        }
+        std::vector<abs_type> K=count_posts(str);
+        std::vector<arena_set*> D=new_set_vector(no_states);
+        solve_reach_avoid_game(str,friendly_dist,K,D);
         return D;
     }
     /*! Solve Buchi game with additional safety objective.
+     *
+     *  The outer greatest fixpoint is warm-started: since YY only shrinks, the allowed inputs of the target states are only updated for the predecessors of the states which left YY, and the inner reachability game keeps its counters across the iterations (see ReachAvoidObjective), so that each iteration only recomputes the part of the attractor which depended on the dropped targets.
      *
      *  \param[in] str            string specifying the sure/maybe winning condition
      *  \param[out] D             optimal state-input pairs */
-    std::vector<unordered_set<abs_type>*> solve_liveness_game(const char* str="sure") {
+    std::vector<arena_set*> solve_liveness_game(const char* str="sure") {
         /* sanity check */
-        if (!strcmp(str,"sure") && !strcmp(str,"maybe")) {
+        if (strcmp(str,"sure") && strcmp(str,"maybe")) {
             try {
                 throw std::runtime_error("Liveness Game: invalid input.");
             } catch (std::exception& e) {
                 std::cout << e.what() << "\n";
             }
         }
+        bool sure=!strcmp(str,"sure");
         /* the outer nu variable */
-        std::unordered_set<abs_type> YY, YY_old;
+        std::unordered_set<abs_type> YY;
+        /* the states which left YY since the allowed inputs of the targets were last updated */
+        std::vector<abs_type> YY_left;
         for (abs_type i=0; i<no_states; i++) {
             YY.insert(i);
         }
         /* set of allowed inputs for the target states = non-blocking inputs (control input when str=sure, joint input when str=maybe) indexed by the state indices */
-        std::vector<std::unordered_set<abs_type>*> D;
+        std::vector<arena_set*> D;
         for (abs_type i=0; i<no_states; i++) {
-            std::unordered_set<abs_type>* s = new std::unordered_set<abs_type>;
+            arena_set* s = new_set();
             D.push_back(s);
             /* if i is not in target, then do not add any input for i */
             if (monitor_target_states_.find(i) == monitor_target_states_.end()) {
@@ -270,8 +176,8 @@ public:
             }
             for (abs_type j=0; j<no_control_inputs; j++) {
                 for (abs_type k=0; k<no_dist_inputs; k++) {
-                    if (no_post[addr_xuw(i,j,k)]!=0) {
-                        if (!strcmp(str,"sure")) {
+                    if (no_post(addr_xuw(i,j,k))!=0) {
+                        if (sure) {
                             D[i]->insert(j);
                             break;
                         } else {
@@ -284,53 +190,63 @@ public:
         /* the inner mu variable */
         std::unordered_set<abs_type> XX;
         /* the strategy from the non-target states */
-        std::vector<unordered_set<abs_type>*> reach_win;
+        std::vector<arena_set*> reach_win=new_set_vector(no_states);
+        /* the transitions do not change, so the post counts of the inner reachability game are computed only once */
+        std::vector<abs_type> no_posts=count_posts(str);
+        std::vector<arena_set*> friendly_dist=new_set_vector(no_states);
         /* the target states from where it is possible to stay inside the winning region for at least one step */
         std::unordered_set<abs_type> safe_targets;
+        /* the inner reachability game (the one of the semantics of str is used): the safe targets only shrink, so every iteration continues from the counters of the last one */
+        ReachAvoidObjective<SureSemantics> sure_reach(safe_targets,monitor_avoid_states_,friendly_dist,no_posts,reach_win,true);
+        ReachAvoidObjective<MaybeSemantics> maybe_reach(safe_targets,monitor_avoid_states_,friendly_dist,no_posts,reach_win,true);
         /* iterate until a fix-point of YY is reached */
-        while (YY_old.size()!=YY.size()) {
-            /* save the current YY */
-            YY_old=YY;
-            /* the set of targets from which it is possible to stay in YY in the next step */
-            safe_targets.clear();
-            for (auto i=monitor_target_states_.begin(); i!=monitor_target_states_.end(); ++i) {
-                /* only consider i from the intersection of YY and target */
-                if (YY.find(*i)==YY.end()) {
-                    continue;
-                }
+        size_t no_YY_old=0;
+        while (no_YY_old!=YY.size()) {
+            /* save the size of the current YY */
+            no_YY_old=YY.size();
+            /* if a successor left YY, then the corresponding state-action pair of a target is unsafe */
+            for (size_t n=0; n<YY_left.size(); n++) {
+                abs_type x=YY_left[n];
+                /* a target outside YY is not winning */
+                D[x]->clear();
                 for (abs_type j=0; j<no_control_inputs; j++) {
                     for (abs_type k=0; k<no_dist_inputs; k++) {
-                        /* the address to look up in the post array */
-                        abs_type l=addr_xuw(*i,j,k);
-                        for (auto i2=post[l]->begin(); i2!=post[l]->end(); ++i2) {
-                            /* if the successor i2 is not in YY, then the corresponding state-action pair is unsafe */
-                            if (YY.find(*i2)==YY.end()) {
-                                if (!strcmp(str,"sure")) {
-                                    D[*i]->erase(j);
-                                } else {
-                                    D[*i]->erase(addr_uw(j,k));
-                                }
-                                continue;
+                        abs_ptr_type x2=addr_xuw(x,j,k);
+                        for_each_pre(x2,[&](const abs_type i) {
+                            if (!enabled_[addr_xuw(i,j,k)] ||
+                                monitor_target_states_.find(i)==monitor_target_states_.end()) {
+                                return;
                             }
-                        }
+                            if (sure) {
+                                D[i]->erase(j);
+                            } else {
+                                D[i]->erase(addr_uw(j,k));
+                            }
+                        });
                     }
                 }
-                /* the safe targets are those which have some action that makes sure that the successor is in YY */
-                if (D[*i]->size()!=0) {
+            }
+            YY_left.clear();
+            /* the safe targets are those in YY which have some action that makes sure that the successor is in YY */
+            safe_targets.clear();
+            for (auto i=monitor_target_states_.begin(); i!=monitor_target_states_.end(); ++i) {
+                if (YY.find(*i)!=YY.end() && D[*i]->size()!=0) {
                     safe_targets.insert(*i);
                 }
             }
-            /* create a new monitor with safe_targets as the true targets */
-            negotiation::LivenessGame monitor2(*this);
-            monitor2.monitor_target_states_=safe_targets;
-            /* solve reach_avoid_game on monitor2 */
-            reach_win.clear();
-            reach_win=monitor2.solve_reach_avoid_game(str);
-            /* create a vector of the winning states in the reach_avoid game */
+            /* solve reach_avoid_game with safe_targets as the true targets */
+            if (sure) {
+                solve_attractor(*this,sure_reach,no_threads_);
+            } else {
+                solve_attractor(*this,maybe_reach,no_threads_);
+            }
+            /* create a vector of the winning states in the reach_avoid game (within YY) */
             XX.clear();
             for (abs_type i=0; i<no_states; i++) {
-                if (reach_win[i]->size()!=0) {
+                if (reach_win[i]->size()!=0 && YY.find(i)!=YY.end()) {
                     XX.insert(i);
+                } else if (YY.find(i)!=YY.end()) {
+                    YY_left.push_back(i);
                 }
             }
             YY=XX;
@@ -371,10 +287,14 @@ public:
             /* UPTO HERE IS NEEDED WHEN 0 IS A TARGET DURING MAYBE_WIN */
         }
         /* the liveness winning strategy is union of the winning strategy of reachability and the winning strategy of safety from the winning target states */
-        std::vector<std::unordered_set<abs_type>*> live_win;
+        std::vector<arena_set*> live_win;
         for (abs_type i=0; i<no_states; i++) {
-            std::unordered_set<abs_type>* set = new std::unordered_set<abs_type>;
+            arena_set* set = new_set();
             live_win.push_back(set);
+            if (YY.find(i)==YY.end()) {
+                /* the state i is losing */
+                continue;
+            }
             if (D[i]->size()!=0) {
                 /* the state i is in the target, so use the safety part */
                 *live_win[i]=*D[i];
@@ -391,7 +311,7 @@ public:
     int find_spoilers(negotiation::SafetyAutomaton* spoilers) {
         int out_flag;
         /* solve the liveness game with sure semantics */
-        std::vector<unordered_set<abs_type>*> sure_win = solve_liveness_game("sure");
+        std::vector<arena_set*> sure_win = solve_liveness_game("sure");
         /* if all the initial states are sure winning, then the set of spoiling behaviors is empty */
         bool allInitSureWinning=true;
         for (auto i=init_.begin(); i!=init_.end(); ++i) {
@@ -410,7 +330,7 @@ public:
         /* assumption violation is removed from target to avoid direct help from falsifying the assumption */
         monitor_target_states_.erase(0);
         /* solve the liveness game with maybe semantics */
-        std::vector<unordered_set<abs_type>*> maybe_win_without_assumption_violation = solve_liveness_game("maybe");
+        std::vector<arena_set*> maybe_win_without_assumption_violation = solve_liveness_game("maybe");
         /* restore assumption violation as target state for future solution of sure winning */
         monitor_target_states_.insert(0);
         /* if not all the initial states are maybe winning, then no negotiation is possible: return false */
@@ -426,135 +346,113 @@ public:
             return out_flag;
         }
         /* compute the set of states reachable from the intitial states */
-        std::unordered_set<abs_type> R = compute_reachable_set();
+        compute_reachable_bitset();
         /* find intersection of the reachable set with the maybe winning region */
         std::unordered_set<abs_type> W;
-        for (auto i=R.begin(); i!=R.end(); ++i) {
-            if (maybe_win_without_assumption_violation[*i]->size()!=0) {
-                W.insert(*i);
-            }
-        }
-        /* save the post array and number of post elements for possible modification */
-        /* number of elements in the post array */
-        abs_type L=no_states*no_control_inputs*no_dist_inputs;
-        std::unordered_set<abs_type>** post_old = new std::unordered_set<abs_type>*[L];
-        for (abs_type l=0; l<L; l++) {
-            std::unordered_set<abs_type>* set=new std::unordered_set<abs_type>;
-            for (auto i=post[l]->begin(); i!=post[l]->end(); ++i) {
-                set->insert(*i);
+        for (abs_type i=0; i<no_states; i++) {
+            if (is_reachable(i) && maybe_win_without_assumption_violation[i]->size()!=0) {
+                W.insert(i);
             }
-            post_old[l]=set;
         }
-        std::vector<abs_type> no_post_old=no_post;
+        /* save the enabled transitions for possible modification (the transitions themselves are never modified) */
+        std::vector<bool> enabled_old=enabled_;
         /* a vector containing the bad inputs for each state index */
-        std::vector<std::unordered_set<abs_type>*> bad_pairs;
-        /* compute unsafe pairs as a vector of the same size as the number of states, where the element with index i points to the set of bad disturbance inputs for state i */
+        std::vector<arena_set*> bad_pairs=new_set_vector(no_states);
+        /* the state-disturbance input pairs found by find_bad_pairs (the buffer is reused by all the calls) */
+        std::vector<std::pair<abs_type,abs_type>> found_pairs;
+        /* compute the unsafe pairs */
         /* it is okay to have successors going to state 0 while computing bad pairs */
         std::unordered_set<abs_type> W_with_0=W;
         W_with_0.insert(0);
-        std::vector<std::unordered_set<abs_type>*> unsafe_pairs=find_bad_pairs(W,W_with_0);
-        /* update the bad pairs */
-        for (abs_type i=0; i<no_states; i++) {
-            std::unordered_set<abs_type>* set=new std::unordered_set<abs_type>;
-            for (auto k=unsafe_pairs[i]->begin(); k!=unsafe_pairs[i]->end(); ++k) {
-                set->insert(*k);
-            }
-            bad_pairs.push_back(set);
-        }
-        /* update the transition system by removing all the successors of the elements in bad_pairs */
-        for (abs_type i=0; i<no_states; i++) {
-            for (auto k=bad_pairs[i]->begin(); k!=bad_pairs[i]->end(); ++k) {
-                for (abs_type j=0; j<no_control_inputs; j++) {
-                    abs_type addr_post = addr_xuw(i,j,*k);
-                    for (auto i2=post[addr_post]->begin(); i2!=post[addr_post]->end(); ++i2) {
-                        pre[addr_xuw(*i2,j,*k)]->erase(i);
-                    }
-                    post[addr_post]->clear();
-                    no_post[addr_post]=0;
-                }
+        find_bad_pairs(W,W_with_0,found_pairs);
+        /* update the bad pairs, and the transition system by removing all the successors of the unsafe pairs */
+        for (size_t n=0; n<found_pairs.size(); n++) {
+            abs_type i=found_pairs[n].first, k=found_pairs[n].second;
+            bad_pairs[i]->insert(k);
+            for (abs_type j=0; j<no_control_inputs; j++) {
+                disable(addr_xuw(i,j,k));
             }
         }
-        /* trim the unreachable transitions from the monitor */
+        /* trim the unreachable transitions from the monitor; this also leaves the reachable set of states of the updated transition system in the bitset */
         trim_transitions();
-       /* compute the reachable set of states with this updated transition system */
-        R = compute_reachable_set();
         /* restrict W to the current reachable set */
         for (abs_type i=0; i<no_states; i++) {
-            if (R.find(i)==R.end()) {
+            if (!is_reachable(i)) {
                 W.erase(i);
             }
         }
         /* save the old target states, as target states will be updated */
         std::unordered_set<abs_type> monitor_target_states_old=monitor_target_states_;
         /* remove those targets which are not in the reachable part of maybe winning region */
-        for (auto im=monitor_target_states_.begin(); im!=monitor_target_states_.end(); ++im) {
+        for (auto im=monitor_target_states_.begin(); im!=monitor_target_states_.end(); ) {
             if (W.find(*im)==W.end() &&
                 *im!=0) {
-                monitor_target_states_.erase(*im);
+                im=monitor_target_states_.erase(im);
+            } else {
+                ++im;
             }
         }
         /* initialize set of states for iteratively computing the LiveLockPairs */
-        std::unordered_set<abs_type> T_cur, T_old;
+        std::unordered_set<abs_type> T_cur, T_cur_with_0;
         for (auto i=monitor_target_states_.begin(); i!=monitor_target_states_.end(); ++i) {
             T_cur.insert(*i);
+            T_cur_with_0.insert(*i);
         }
+        /* it is okay for a successor state to go to 0 while computing live lock pairs */
+        T_cur_with_0.insert(0);
         /* initialize live_lock_pairs */
-        std::vector<std::unordered_set<abs_type>*> live_lock_pairs;
-        for (abs_type i=0; i<no_states; i++) {
-            std::unordered_set<abs_type>* set = new std::unordered_set<abs_type>;
-            live_lock_pairs.push_back(set);
-        }
+        std::vector<arena_set*> live_lock_pairs=new_set_vector(no_states);
+        /* the sure reachability game is solved incrementally: the targets only grow, and between two iterations the transitions only change locally */
+        init_sure_win();
+        /* in the first iteration all the states are checked for live lock pairs, afterwards only those marked in live_lock_dirty_ */
+        bool first_iteration=true;
         /* repeat until convergence and when no new live lock pairs could be found in the last iteration*/
+        bool target_updated=(T_cur.size()!=0);
         bool live_lock_pair_updated=false;
-        while (T_old!=T_cur || live_lock_pair_updated) {
+        while (target_updated || live_lock_pair_updated) {
             live_lock_pair_updated=false;
-            /* save the current targets */
-            T_old=T_cur;
-            /* update the monitor target states */
-            monitor_target_states_=T_cur;
-            /* solve sure reachability game */
-            sure_win=solve_reach_avoid_game("sure");
+            /* solve sure reachability game by propagating from the new targets and the edited transitions */
+            propagate_sure_win();
             /* add back the deleted transitions for those livelock pairs for which the respective states are still not sure winning */
             for (abs_type i=0; i<no_states; i++) {
                 if (live_lock_pairs[i]->size()!=0 &&
-                    sure_win[i]->size()==0) {
+                    !sure_win_inc_[i]) {
                     for (abs_type j=0; j<no_control_inputs; j++) {
                         for (auto k=live_lock_pairs[i]->begin(); k!=live_lock_pairs[i]->end(); ++k) {
-                            *post[addr_xuw(i,j,*k)]=*post_old[addr_xuw(i,j,*k)];
-                            no_post[addr_xuw(i,j,*k)]=no_post[addr_xuw(i,j,*k)];
-                            for (auto i2=post[addr_xuw(i,j,*k)]->begin(); i2!=post[addr_xuw(i,j,*k)]->end(); ++i2) {
-                                pre[addr_xuw(*i2,j,*k)]->insert(i);
-                            }
+                            restore_transition(i,j,*k,enabled_old);
                         }
                     }
                     /* also clear the live_lock_pairs entry */
                     live_lock_pairs[i]->clear();
                 }
             }
-            /* update the current target */
-            for (abs_type i=0; i<no_states; i++) {
-                if (sure_win[i]->size()!=0) {
-                    T_cur.insert(i);
+            /* update the current target with the newly found sure winning states */
+            target_updated=false;
+            for (size_t n=0; n<sure_win_new_.size(); n++) {
+                abs_type i=sure_win_new_[n];
+                if (T_cur.insert(i).second) {
+                    T_cur_with_0.insert(i);
+                    target_updated=true;
                 }
             }
-            /* update post: block all control strategies which take the system to the sure losing region */
-            for (abs_type i=0; i<no_states; i++) {
-                /* only consider the states which are sure winning */
-                if (sure_win[i]->size()==0) {
-                    continue;
-                }
+            /* update post: block all control strategies which take the system to the sure losing region
+             * (the transitions of the states which were sure winning before are not restored, so they were already processed) */
+            for (size_t n=0; n<sure_win_new_.size(); n++) {
+                abs_type i=sure_win_new_[n];
                 for (abs_type j=0; j<no_control_inputs; j++) {
                     /* assume that this input is winning */
                     bool winning_input=true;
                     for (abs_type k=0; k<no_dist_inputs; k++) {
-                        abs_type addr_post=addr_xuw(i,j,k);
-                        for (auto i2=post[addr_post]->begin(); i2!=post[addr_post]->end(); ++i2) {
+                        abs_ptr_type addr_post=addr_xuw(i,j,k);
+                        if (!enabled_[addr_post]) {
+                            continue;
+                        }
+                        for_each_post(addr_post,[&](const abs_type i2) {
                             /* if the current post is outside maybe winning region or the sink state 0, delete all the posts for all the other disturbance inputs */
-                            if (W_with_0.find(*i2)==W_with_0.end()) {
+                            if (W_with_0.find(i2)==W_with_0.end()) {
                                 winning_input=false;
-                                break;
                             }
-                        }
+                        });
                         if (!winning_input) {
                             break;
                         }
@@ -562,52 +460,45 @@ public:
                     /* if this control input is not winning, clear all the posts for this control input */
                     if (!winning_input) {
                         for (abs_type k2=0; k2<no_dist_inputs; k2++) {
-                            abs_type addr_post2=addr_xuw(i,j,k2);
-                            for (auto i2=post[addr_post2]->begin(); i2!=post[addr_post2]->end(); ++i2) {
-                                pre[addr_xuw(*i2,j,k2)]->erase(i);
-                            }
-                            post[addr_post2]->clear();
-                            no_post[addr_post2]=0;
+                            disable(addr_xuw(i,j,k2));
                         }
                     }
                 }
             }
+            sure_win_new_.clear();
             /* compute live lock pairs */
-            /* find complement of T_cur */
+            /* the candidates are the states outside T_cur (except 0) whose transitions or whose successors changed since the last iteration: for the rest, the live lock pairs found before have been removed and no new ones can appear */
             std::unordered_set<abs_type> T_cur_cmp;
-            for (abs_type i=0; i<no_states; i++) {
-                if (T_cur.find(i)==T_cur.end()) {
-                    T_cur_cmp.insert(i);
+            if (first_iteration) {
+                for (abs_type i=1; i<no_states; i++) {
+                    if (T_cur.find(i)==T_cur.end()) {
+                        T_cur_cmp.insert(i);
+                    }
                 }
-            }
-            /* it is okay for a successor state to go to 0 while computing live lock pairs */
-            std::unordered_set<abs_type> T_cur_with_0=T_cur;
-            T_cur_with_0.insert(0);
-            T_cur_cmp.erase(0);
-            /* update LiveLockPairs */
-            std::vector<std::unordered_set<abs_type>*> live_lock_pairs_new=find_bad_pairs(T_cur_cmp,T_cur_with_0);
-            /* update the live_lock_pairs with the newly founded ones */
-            for (abs_type i=0; i<no_states; i++) {
-                for (auto k=live_lock_pairs_new[i]->begin(); k!=live_lock_pairs_new[i]->end(); ++k) {
-                    live_lock_pairs[i]->insert(*k);
-                    live_lock_pair_updated=true;
+                first_iteration=false;
+            } else {
+                for (auto i=live_lock_dirty_.begin(); i!=live_lock_dirty_.end(); ++i) {
+                    if (*i!=0 && T_cur.find(*i)==T_cur.end()) {
+                        T_cur_cmp.insert(*i);
+                    }
                 }
             }
-            /* update post (remove all the transitions caused due to elements in live_lock_pairs) */
-            for (abs_type i=0; i<no_states; i++) {
-                for (auto k=live_lock_pairs[i]->begin(); k!=live_lock_pairs[i]->end(); ++k) {
-                    // bad_pairs[i]->insert(*k);
-                    for (abs_type j=0; j<no_control_inputs; j++) {
-                        abs_type addr_post=addr_xuw(i,j,*k);
-                        for (auto i2=post[addr_post]->begin(); i2!=post[addr_post]->end(); ++i2) {
-                            pre[addr_xuw(*i2,j,*k)]->erase(i);
-                        }
-                        post[addr_post]->clear();
-                        no_post[addr_post]=0;
-                    }
+            live_lock_dirty_.clear();
+            /* update LiveLockPairs */
+            find_bad_pairs(T_cur_cmp,T_cur_with_0,found_pairs);
+            for (size_t n=0; n<found_pairs.size(); n++) {
+                abs_type i=found_pairs[n].first, k=found_pairs[n].second;
+                /* update the live_lock_pairs with the newly founded ones */
+                live_lock_pairs[i]->insert(k);
+                live_lock_pair_updated=true;
+                /* update post (remove all the transitions caused due to the new live lock pair; those of the older ones are already removed) */
+                for (abs_type j=0; j<no_control_inputs; j++) {
+                    disable_transition(i,j,k);
                 }
             }
         }
+        /* the final targets */
+        monitor_target_states_=T_cur;
         /* if the initial states could not be added to the sure winning region, then return 0: no negotiation is possible */
         for (auto i=init_.begin(); i!=init_.end(); ++i) {
             if (T_cur.find(*i)==T_cur.end()) {
@@ -621,7 +512,7 @@ public:
             }
         }
         /* find the reachable states using the updated post */
-        R = compute_reachable_set();
+        compute_reachable_bitset();
 
         /* construct the spoilers safety automaton */
         /* map from new state indices to old state indices: all the losing states (i.e. no maybe winning) are lumped in state 0 */
@@ -631,7 +522,7 @@ public:
         /* the old "reject_A" state is mapped to index 1 */
         /* for the rest of the reachable monitor states, a new state index is created, and all the losing and unreachable monitor states are mapped to state 0 */
         for (abs_type i=2; i<no_states; i++) {
-            if (R.find(i)!=R.end()) {
+            if (is_reachable(i)) {
                 old_state_ind.push_back(i);
             }
         }
@@ -646,10 +537,9 @@ public:
         }
         spoilers->no_inputs_=no_dist_inputs;
         /* construct the post transition array of the safety automaton */
-        std::unordered_set<abs_type>** p=new std::unordered_set<abs_type>*[no_new_states*no_dist_inputs];
-        for (abs_type i=0; i<no_new_states*no_dist_inputs; i++) {
-            std::unordered_set<abs_type>* v=new std::unordered_set<abs_type>;
-            p[i]=v;
+        arena_set** p=new_set_array(abs_ptr_type(no_new_states)*no_dist_inputs);
+        for (abs_ptr_type i=0; i<abs_ptr_type(no_new_states)*no_dist_inputs; i++) {
+            p[i]=new_set();
         }
         /* first add self loops to the reject state */
         for (abs_type k=0; k<no_dist_inputs; k++) {
@@ -658,14 +548,14 @@ public:
         for (abs_type q=1; q<no_new_states; q++) {
             abs_type i=old_state_ind[q];
             for (abs_type k=0; k<no_dist_inputs; k++) {
-                abs_type addr_post=addr_xw(q,k);
+                abs_ptr_type addr_post=addr_xw(q,k);
                 if (bad_pairs[i]->find(k)!=bad_pairs[i]->end()) {
                     p[addr_post]->insert(0);
                 } else {
                     for (abs_type j=0; j<no_control_inputs; j++) {
                         for (abs_type q2=0; q2<no_new_states; q2++) {
                             abs_type i2=old_state_ind[q2];
-                            if (post[addr_xuw(i,j,k)]->find(i2)!=post[addr_xuw(i,j,k)]->end()) {
+                            if (enabled_[addr_xuw(i,j,k)] && has_post(addr_xuw(i,j,k),i2)) {
                                 p[addr_post]->insert(q2);
                             }
                         }
@@ -674,17 +564,9 @@ public:
             }
         }
         spoilers->addPost(p);
-        /* restore post, no_post, monitor_target_states_*/
+        /* restore the enabled transitions, monitor_target_states_*/
         monitor_target_states_=monitor_target_states_old;
-        for (abs_type l=0; l<no_states*no_control_inputs*no_dist_inputs; l++) {
-            post[l]->clear();
-            for (auto i=post_old[l]->begin(); i!=post_old[l]->end(); ++i) {
-                post[l]->insert(*i);
-            }
-        }
-        no_post=no_post_old;
-        delete[] p;
-        delete[] post_old;
+        enabled_=enabled_old;
 
         out_flag=1;
         return out_flag;
@@ -695,66 +577,217 @@ public:
      *      - all posts of (x,u,w2) are in W2
      *      - there exists a post of (x,u,w1) which is not in W2.
      *
+     * For each state-control input pair, one pass over the posts summarizes the disturbance inputs in a bit mask of those with a post outside W2, and a flag telling whether some disturbance is friendly (at least one post and all posts in W2). (x,w1) is then a bad pair for the control input u if w1 is in the mask and the flag is set (w1 itself can not be friendly), so the cost is linear in the number of transitions.
+     *
      * \param[in] W1        the set W1
      * \param[in] W2        the set W2
-     * \param[out] bad_pairs    the pairs which satisfy the above conditions */
-    std::vector<unordered_set<abs_type>*> find_bad_pairs(const unordered_set<abs_type> W1, const unordered_set<abs_type> W2) {
-        /* initialize the bad pairs vector */
-        std::vector<unordered_set<abs_type>*> bad_pairs;
-        for (abs_type i=0; i<no_states; i++) {
-            std::unordered_set<abs_type>* set=new std::unordered_set<abs_type>;
-            bad_pairs.push_back(set);
-        }
-        for (abs_type i=0; i<no_states; i++) {
-            /* only states in W1 can be in bad pairs */
-            if (W1.find(i)==W1.end()) {
-                continue;
-            }
+     * \param[out] bad_pairs    the pairs (x,w1) which satisfy the above conditions, each listed once (the vector is cleared first, so the caller can reuse it across the calls) */
+    void find_bad_pairs(const unordered_set<abs_type>& W1, const unordered_set<abs_type>& W2,
+                        std::vector<std::pair<abs_type,abs_type>>& bad_pairs) {
+        bad_pairs.clear();
+        /* membership in W2 as a bit vector (all false between the calls) */
+        in_W2_.resize(no_states,false);
+        for (auto i=W2.begin(); i!=W2.end(); ++i) {
+            if (*i<no_states) {
+                in_W2_[*i]=true;
+            }
+        }
+        /* the bit masks over the disturbance inputs: those with a post outside W2 for the current control input, and the bad ones for the current state */
+        const size_t no_words=(no_dist_inputs+63)/64;
+        std::vector<uint64_t> leaving(no_words), bad(no_words);
+        /* only states in W1 can be in bad pairs */
+        for (auto it=W1.begin(); it!=W1.end(); ++it) {
+            abs_type i=*it;
+            std::fill(bad.begin(),bad.end(),0);
             for (abs_type j=0; j<no_control_inputs; j++) {
+                std::fill(leaving.begin(),leaving.end(),0);
+                bool some_friendly=false;
                 for (abs_type k=0; k<no_dist_inputs; k++) {
                     /* address in the post array */
-                    abs_type addr_post = addr_xuw(i,j,k);
-                    for (auto i2=post[addr_post]->begin(); i2!=post[addr_post]->end(); ++i2) {
-                        /* if this post is outside W2, then this pair (i,k) could potentially be an unsafe pair */
-                        bool is_bad_pair=false;
-                        if (W2.find(*i2)==W2.end()) {
-                            for (abs_type k2=0; k2<no_dist_inputs; k2++) {
-                                if (k==k2) {
-                                    continue;
-                                }
-                                /* address in the post array */
-                                abs_type addr_post2 = addr_xuw(i,j,k2);
-                                /* the disturbance k2 is friendly if there is at least one successor, and all the successors are in W2 */
-                                bool friendly_disturbance;
-                                if (post[addr_post2]->size()==0) {
-                                    friendly_disturbance=false;
-                                } else {
-                                    friendly_disturbance=true;
-                                    for (auto i3=post[addr_post2]->begin(); i3!=post[addr_post2]->end(); ++i3) {
-                                        if (W2.find(*i3)==W2.end()) {
-                                            friendly_disturbance=false;
-                                            break;
-                                        }
-                                    }
-                                }
-                                /* if k2 is friendly, then (i,k) is an unsafe pair */
-                                if (friendly_disturbance) {
-                                    bad_pairs[i]->insert(k);
-                                    is_bad_pair=true;
-                                    break;
-                                }
-                            }
-                        }
-                        /* the current (i,k) pair is already an unsafe pair: proceed with the next k */
-                        if (is_bad_pair) {
-                            break;
+                    abs_ptr_type addr_post = addr_xuw(i,j,k);
+                    if (!enabled_[addr_post] || post_size(addr_post)==0) {
+                        continue;
+                    }
+                    bool all_in_W2=true;
+                    for_each_post(addr_post,[&](const abs_type i2) {
+                        if (!in_W2_[i2]) {
+                            all_in_W2=false;
                         }
+                    });
+                    if (all_in_W2) {
+                        some_friendly=true;
+                    } else {
+                        leaving[k/64]|=(uint64_t(1)<<(k%64));
                     }
                 }
+                /* without a friendly disturbance there is no bad pair for this control input */
+                if (some_friendly) {
+                    for (size_t w=0; w<no_words; w++) {
+                        bad[w]|=leaving[w];
+                    }
+                }
+            }
+            for (size_t w=0; w<no_words; w++) {
+                for (uint64_t bits=bad[w]; bits!=0; bits&=bits-1) {
+                    bad_pairs.push_back(std::make_pair(i,abs_type(w*64+__builtin_ctzll(bits))));
+                }
             }
         }
-        return bad_pairs;
-
+        for (auto i=W2.begin(); i!=W2.end(); ++i) {
+            if (*i<no_states) {
+                in_W2_[*i]=false;
+            }
+        }
+    }
+private:
+    /*! Count the posts of all the state-input pairs: for each (i,j) when str=sure, and for each (i,j,k) when str=maybe.
+     * \param[in] str         string specifying the sure/maybe winning condition
+     * \param[out] K          the number of posts */
+    std::vector<abs_type> count_posts(const char* str) {
+        if (!strcmp(str,"sure")) {
+            return negotiation::count_posts<SureSemantics>(*this);
+        } else {
+            return negotiation::count_posts<MaybeSemantics>(*this);
+        }
+    }
+    /*! Solve reach-avoid game (see the public overload) reusing the post counts and the output sets of an earlier call.
+     * \param[in] str             string specifying the sure/maybe winning condition
+     * \param[in] friendly_dist   disturbance inputs to ignore
+     * \param[in] no_posts        the number of posts as computed by count_posts(str) (valid as long as the transitions do not change)
+     * \param[out] D              optimal state-input pairs (overwritten; must have one set per state) */
+    void solve_reach_avoid_game(const char* str, std::vector<arena_set*>& friendly_dist,
+                                const std::vector<abs_type>& no_posts,
+                                std::vector<arena_set*>& D) {
+        if (!strcmp(str,"sure")) {
+            ReachAvoidObjective<SureSemantics> objective(monitor_target_states_,monitor_avoid_states_,friendly_dist,no_posts,D);
+            solve_attractor(*this,objective,no_threads_);
+        } else {
+            ReachAvoidObjective<MaybeSemantics> objective(monitor_target_states_,monitor_avoid_states_,friendly_dist,no_posts,D);
+            solve_attractor(*this,objective,no_threads_);
+        }
+    }
+    /*! [used by find_bad_pairs] membership in the set W2 */
+    std::vector<bool> in_W2_;
+    /*! Sure winning states of the incremental sure reachability game solved in find_spoilers */
+    std::vector<bool> sure_win_inc_;
+    /*! The states which became sure winning since the last time the list was cleared */
+    std::vector<abs_type> sure_win_new_;
+    /*! For each state-control input pair (i,j) (see addr_xu): the number of enabled posts (over all the disturbance inputs) */
+    std::vector<abs_type> no_enabled_post_;
+    /*! For each state-control input pair (i,j) (see addr_xu): the number of enabled posts which are not sure winning */
+    std::vector<abs_type> no_losing_post_;
+    /*! States whose counters changed since the last call to propagate_sure_win */
+    std::queue<abs_type> sure_win_candidates_;
+    /*! States which need to be checked for new live lock pairs: a post of the state became sure winning, or some of its transitions were restored */
+    std::unordered_set<abs_type> live_lock_dirty_;
+    /*! Initialize the incremental sure reachability game with the current target states and the enabled transitions.
+     *
+     * The game is the same as the one solved by solve_reach_avoid_game("sure"), but only the winning region is maintained: a non-avoid state becomes sure winning as soon as for some control input all its enabled posts (and at least one) are sure winning. The targets are marked as winning right away, and the rest is computed by propagate_sure_win. */
+    void init_sure_win() {
+        sure_win_inc_.assign(no_states,false);
+        sure_win_new_.clear();
+        no_enabled_post_.assign(abs_ptr_type(no_states)*no_control_inputs,0);
+        no_losing_post_.assign(abs_ptr_type(no_states)*no_control_inputs,0);
+        sure_win_candidates_=std::queue<abs_type>();
+        live_lock_dirty_.clear();
+        for (abs_type i=0; i<no_states; i++) {
+            for (abs_type j=0; j<no_control_inputs; j++) {
+                for (abs_type k=0; k<no_dist_inputs; k++) {
+                    abs_ptr_type l=addr_xuw(i,j,k);
+                    if (enabled_[l]) {
+                        no_enabled_post_[addr_xu(i,j)]+=post_size(l);
+                        no_losing_post_[addr_xu(i,j)]+=post_size(l);
+                    }
+                }
+            }
+        }
+        for (auto i=monitor_target_states_.begin(); i!=monitor_target_states_.end(); ++i) {
+            add_sure_win(*i);
+        }
+    }
+    /*! Mark a state as sure winning and update the counters of its predecessors.
+     * \param[in] x     the state */
+    void add_sure_win(const abs_type x) {
+        sure_win_inc_[x]=true;
+        sure_win_new_.push_back(x);
+        for (abs_type j=0; j<no_control_inputs; j++) {
+            for (abs_type k=0; k<no_dist_inputs; k++) {
+                abs_ptr_type x2=addr_xuw(x,j,k);
+                for_each_pre(x2,[&](const abs_type i) {
+                    if (!enabled_[addr_xuw(i,j,k)]) {
+                        return;
+                    }
+                    live_lock_dirty_.insert(i);
+                    if (sure_win_inc_[i]) {
+                        return;
+                    }
+                    if (--no_losing_post_[addr_xu(i,j)]==0) {
+                        sure_win_candidates_.push(i);
+                    }
+                });
+            }
+        }
+    }
+    /*! Propagate the sure winning region from the candidates until a fixed point is reached. */
+    void propagate_sure_win() {
+        while (sure_win_candidates_.size()!=0) {
+            abs_type x=sure_win_candidates_.front();
+            sure_win_candidates_.pop();
+            if (sure_win_inc_[x] ||
+                monitor_avoid_states_.find(x)!=monitor_avoid_states_.end()) {
+                continue;
+            }
+            for (abs_type j=0; j<no_control_inputs; j++) {
+                if (no_losing_post_[addr_xu(x,j)]==0 && no_enabled_post_[addr_xu(x,j)]!=0) {
+                    add_sure_win(x);
+                    break;
+                }
+            }
+        }
+    }
+    /*! Disable a transition and update the counters of the incremental sure reachability game.
+     * \param[in] i     state index
+     * \param[in] j     control input index
+     * \param[in] k     disturbance input index */
+    void disable_transition(const abs_type i, const abs_type j, const abs_type k) {
+        abs_ptr_type l=addr_xuw(i,j,k);
+        if (!enabled_[l]) {
+            return;
+        }
+        if (!sure_win_inc_[i]) {
+            for_each_post(l,[&](const abs_type i2) {
+                no_enabled_post_[addr_xu(i,j)]--;
+                if (!sure_win_inc_[i2]) {
+                    no_losing_post_[addr_xu(i,j)]--;
+                }
+            });
+            sure_win_candidates_.push(i);
+        }
+        disable(l);
+    }
+    /*! Restore a transition to a saved state and update the counters of the incremental sure reachability game.
+     * \param[in] i             state index
+     * \param[in] j             control input index
+     * \param[in] k             disturbance input index
+     * \param[in] enabled_old   the saved enable bits */
+    void restore_transition(const abs_type i, const abs_type j, const abs_type k,
+                            const std::vector<bool>& enabled_old) {
+        abs_ptr_type l=addr_xuw(i,j,k);
+        /* transitions are only ever disabled after the save, so there is nothing to do unless it was enabled then */
+        if (enabled_[l] || !enabled_old[l]) {
+            return;
+        }
+        if (!sure_win_inc_[i]) {
+            for_each_post(l,[&](const abs_type i2) {
+                no_enabled_post_[addr_xu(i,j)]++;
+                if (!sure_win_inc_[i2]) {
+                    no_losing_post_[addr_xu(i,j)]++;
+                }
+            });
+            sure_win_candidates_.push(i);
+        }
+        live_lock_dirty_.insert(i);
+        enabled_[l]=true;
     }
 }; /* end of class definition */
 } /* end of namespace negotiation */
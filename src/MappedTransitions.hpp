@@ -0,0 +1,310 @@
+/* MappedTransitions.hpp
+ *
+ *  Date: 19/10/2026 */
+
+/** @file **/
+#ifndef MAPPEDTRANSITIONS_HPP_
+#define MAPPEDTRANSITIONS_HPP_
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <cstdint>
+#include <limits>
+#include <cstring>
+#include <cerrno>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "Component.hpp" /* for the definition of data types abs_type and abs_ptr_type */
+
+/** @namespace negotiation **/
+namespace negotiation {
+
+/**
+ *  @class MappedFile
+ *
+ *  @brief A temporary file which is first written sequentially (through a small buffer) and then memory-mapped.
+ *
+ *  The file is unlinked as soon as it is created, so that it disappears with the process. The mapping is shared, so the kernel writes the dirty pages back to the file and evicts them whenever memory is needed; release() additionally drops the pages from the resident set of the process.
+ */
+class MappedFile {
+private:
+    /** @brief the file descriptor **/
+    int fd_;
+    /** @brief the mapping (nullptr while the file is not mapped) **/
+    char* data_;
+    /** @brief the size of the file in bytes **/
+    size_t size_;
+    /** @brief the bytes appended but not yet written **/
+    std::vector<char> buffer_;
+    /** @brief the buffer is written out when it reaches this size **/
+    static const size_t buffer_size_=1<<20;
+public:
+    /*! Constructor: create an empty temporary file
+     * \param[in] dir   the directory of the file */
+    MappedFile(const std::string& dir) : data_(nullptr), size_(0) {
+        std::string name=dir+"/agnes-XXXXXX";
+        std::vector<char> path(name.begin(),name.end());
+        path.push_back('\0');
+        fd_=mkstemp(path.data());
+        if (fd_<0) {
+            throw std::runtime_error("MappedFile: cannot create a temporary file in "+dir+": "+std::strerror(errno));
+        }
+        unlink(path.data());
+    }
+    MappedFile(const MappedFile&)=delete;
+    MappedFile& operator=(const MappedFile&)=delete;
+    /*! Destructor */
+    ~MappedFile() {
+        unmap();
+        close(fd_);
+    }
+    /*! Append the bytes of an array to the file
+     * \param[in] x     the first element
+     * \param[in] n     the number of elements */
+    template<class T>
+    void append(const T* x, const size_t n) {
+        const char* b=reinterpret_cast<const char*>(x);
+        /* the buffer never grows beyond buffer_size_: larger arrays are written right away */
+        if (buffer_.size()+n*sizeof(T)>buffer_size_) {
+            flush();
+        }
+        if (n*sizeof(T)>buffer_size_) {
+            write_all(b,n*sizeof(T));
+        } else {
+            buffer_.reserve(buffer_size_);
+            buffer_.insert(buffer_.end(),b,b+n*sizeof(T));
+        }
+        size_+=n*sizeof(T);
+    }
+    /*! Set the size of the file (the new bytes are zero)
+     * \param[in] bytes     the size in bytes */
+    void resize(const size_t bytes) {
+        flush();
+        unmap();
+        if (ftruncate(fd_,bytes)!=0) {
+            throw std::runtime_error(std::string("MappedFile: cannot resize the file: ")+std::strerror(errno));
+        }
+        size_=bytes;
+    }
+    /*! Map the whole file (after the appends are done)
+     * \param[in] writable  whether the mapping can be written */
+    void map(const bool writable) {
+        flush();
+        std::vector<char>().swap(buffer_);
+        unmap();
+        if (size_==0) {
+            return;
+        }
+        void* p=mmap(nullptr,size_,PROT_READ | (writable ? PROT_WRITE : 0),MAP_SHARED,fd_,0);
+        if (p==MAP_FAILED) {
+            throw std::runtime_error(std::string("MappedFile: cannot map the file: ")+std::strerror(errno));
+        }
+        data_=static_cast<char*>(p);
+        madvise(data_,size_,MADV_SEQUENTIAL);
+    }
+    /*! The mapped data */
+    template<class T>
+    T* data() const {
+        return reinterpret_cast<T*>(data_);
+    }
+    /*! The size of the file in bytes */
+    size_t size() const {
+        return size_;
+    }
+    /*! Drop the mapped pages from the resident set; the data stays in the file */
+    void release() {
+        if (data_) {
+            madvise(data_,size_,MADV_DONTNEED);
+        }
+    }
+private:
+    /*! Write the buffer to the file */
+    void flush() {
+        write_all(buffer_.data(),buffer_.size());
+        buffer_.clear();
+    }
+    /*! Write bytes to the end of the file
+     * \param[in] b     the first byte
+     * \param[in] size  the number of bytes */
+    void write_all(const char* b, const size_t size) {
+        size_t done=0;
+        while (done<size) {
+            ssize_t n=write(fd_,b+done,size-done);
+            if (n<0) {
+                if (errno==EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::string("MappedFile: cannot write the file: ")+std::strerror(errno));
+            }
+            done+=n;
+        }
+    }
+    /*! Remove the mapping */
+    void unmap() {
+        if (data_) {
+            munmap(data_,size_);
+            data_=nullptr;
+        }
+    }
+};/* end of class definition */
+
+/**
+ *  @class MappedTransitions
+ *
+ *  @brief The pre and post arrays of a monitor in compressed sparse row form, stored in memory-mapped temporary files.
+ *
+ *  The triples (state, control input, disturbance input) are addressed as in Monitor::addr_xuw. The posts are appended triple by triple in increasing order of the addresses, and the pre array is then obtained by transposition in a few sequential passes over the posts, each of which fills the part of the pre array which fits into the memory budget. The posts of a triple are sorted, and the pres of a triple are sorted by construction.
+ */
+class MappedTransitions {
+private:
+    /** @brief the directory of the temporary files **/
+    std::string dir_;
+    /** @brief number of triples **/
+    size_t no_triples_;
+    /** @brief number of inputs (control inputs times disturbance inputs) **/
+    size_t no_inputs_;
+    /** @brief the resident memory the transposition may use, in bytes **/
+    size_t memory_budget_;
+    /** @brief number of posts appended so far **/
+    std::uint64_t no_posts_;
+    /** @brief the offsets (one per triple, and the total at the end) and the states of the posts and of the pres **/
+    MappedFile post_offsets_, post_, pre_offsets_, pre_;
+public:
+    /*! Constructor
+     * \param[in] dir               the directory of the temporary files
+     * \param[in] no_triples        the number of triples
+     * \param[in] no_inputs         the number of joint inputs per state
+     * \param[in] memory_budget     the resident memory the transposition may use, in bytes */
+    MappedTransitions(const std::string& dir, const size_t no_triples, const size_t no_inputs, const size_t memory_budget) : dir_(dir), no_triples_(no_triples), no_inputs_(no_inputs), memory_budget_(std::max(memory_budget,size_t(1)<<16)), no_posts_(0), post_offsets_(dir), post_(dir), pre_offsets_(dir), pre_(dir) {
+        /* the offset files hold one word per triple and the total, and their sizes must be representable as file offsets */
+        checked_product({abs_ptr_type(no_triples)+1,sizeof(std::uint64_t)},std::numeric_limits<off_t>::max(),"MappedTransitions: the size of the offset files");
+        post_offsets_.append(&no_posts_,1);
+    }
+    /*! Append the posts of the next triple
+     * \param[in] posts     the sorted posts without duplicates */
+    void append_post(const std::vector<abs_type>& posts) {
+        post_.append(posts.data(),posts.size());
+        no_posts_+=posts.size();
+        post_offsets_.append(&no_posts_,1);
+    }
+    /*! Map the posts and compute the pres, once all the posts are appended */
+    void finish() {
+        if (post_offsets_.size()!=(no_triples_+1)*sizeof(std::uint64_t)) {
+            throw std::runtime_error("MappedTransitions: the posts of some triples are missing.");
+        }
+        post_offsets_.map(false);
+        post_.map(false);
+        transpose();
+    }
+    /*! The posts of the triple l: [post_begin(l), post_end(l)) */
+    const abs_type* post_begin(const size_t l) const {
+        return post_.data<abs_type>()+post_offsets_.data<std::uint64_t>()[l];
+    }
+    const abs_type* post_end(const size_t l) const {
+        return post_.data<abs_type>()+post_offsets_.data<std::uint64_t>()[l+1];
+    }
+    /*! The pres of the triple l: [pre_begin(l), pre_end(l)) */
+    const abs_type* pre_begin(const size_t l) const {
+        return pre_.data<abs_type>()+pre_offsets_.data<std::uint64_t>()[l];
+    }
+    const abs_type* pre_end(const size_t l) const {
+        return pre_.data<abs_type>()+pre_offsets_.data<std::uint64_t>()[l+1];
+    }
+    /*! The directory of the temporary files */
+    const std::string& dir() const {
+        return dir_;
+    }
+    /*! The resident memory the transposition may use, in bytes */
+    size_t memory_budget() const {
+        return memory_budget_;
+    }
+    /*! The number of triples whose transitions can be read out of order between two calls to release, so that the pages mapped by the reads fit into a quarter of the memory budget (the kernel maps up to 64 KiB of a file around every page fault, and a triple is read from two files) */
+    size_t random_read_period() const {
+        return std::max(memory_budget_/4/(2*(size_t(64)<<10)),size_t(1));
+    }
+    /*! Drop all the mapped pages from the resident set */
+    void release() {
+        post_offsets_.release();
+        post_.release();
+        pre_offsets_.release();
+        pre_.release();
+    }
+private:
+    /*! Compute the pre array from the post array.
+     *
+     * The pre of the triple (i,j,k) with post x' is the triple (x',j,k), and the pres of a triple are written in increasing order of the states. Both the counting and the filling are done in windows of consecutive pre triples: a window is filled by one sequential pass over the posts, and its offsets and pres fit into half of the memory budget. The pages read sequentially are dropped whenever they may fill a quarter of the budget, so that the resident pages of the files stay within the budget. */
+    void transpose() {
+        const std::uint64_t* post_offsets=post_offsets_.data<std::uint64_t>();
+        const abs_type* posts=post_.data<abs_type>();
+        const size_t window_budget=memory_budget_/2;
+        const size_t read_budget=memory_budget_/4;
+        /* visit the posts whose pre triple is in [begin,end), in increasing order of the post triples */
+        auto sweep = [&](const size_t begin, const size_t end, const std::function<void(size_t,abs_type)>& f) {
+            size_t read=0;
+            for (size_t l=0; l<no_triples_; l++) {
+                size_t input=l%no_inputs_;
+                abs_type i=abs_type(l/no_inputs_);
+                for (std::uint64_t n=post_offsets[l]; n<post_offsets[l+1]; n++) {
+                    size_t l2=size_t(posts[n])*no_inputs_+input;
+                    if (l2>=begin && l2<end) {
+                        f(l2,i);
+                    }
+                }
+                read+=sizeof(std::uint64_t)+(post_offsets[l+1]-post_offsets[l])*sizeof(abs_type);
+                if (read>=read_budget) {
+                    post_offsets_.release();
+                    post_.release();
+                    read=0;
+                }
+            }
+            post_offsets_.release();
+            post_.release();
+        };
+        /* count the pres, window by window, and turn the counts into offsets */
+        pre_offsets_.resize((no_triples_+1)*sizeof(std::uint64_t));
+        pre_offsets_.map(true);
+        std::uint64_t* pre_offsets=pre_offsets_.data<std::uint64_t>();
+        const size_t window=std::max(window_budget/sizeof(std::uint64_t),size_t(1));
+        for (size_t begin=0; begin<no_triples_; begin+=window) {
+            sweep(begin,std::min(begin+window,no_triples_),[&](const size_t l2, const abs_type) {
+                pre_offsets[l2+1]++;
+            });
+            pre_offsets_.release();
+        }
+        for (size_t l=0; l<no_triples_; l++) {
+            pre_offsets[l+1]+=pre_offsets[l];
+            if ((l+1)%(read_budget/sizeof(std::uint64_t)+1)==0) {
+                pre_offsets_.release();
+            }
+        }
+        pre_offsets_.release();
+        /* fill the pres, window by window: the cursors, the pages of the offsets they are read from, and the pres of a window share the budget */
+        pre_.resize(checked_product({pre_offsets[no_triples_],sizeof(abs_type)},std::numeric_limits<off_t>::max(),"MappedTransitions: the size of the pre file"));
+        pre_.map(true);
+        abs_type* pres=pre_.data<abs_type>();
+        std::vector<std::uint64_t> cursor;
+        for (size_t begin=0; begin<no_triples_; ) {
+            size_t end=begin+1;
+            while (end<no_triples_ &&
+                   (end+1-begin)*2*sizeof(std::uint64_t)+(pre_offsets[end+1]-pre_offsets[begin])*sizeof(abs_type)<=window_budget) {
+                end++;
+            }
+            cursor.assign(pre_offsets+begin,pre_offsets+end);
+            sweep(begin,end,[&](const size_t l2, const abs_type i) {
+                pres[cursor[l2-begin]++]=i;
+            });
+            pre_.release();
+            pre_offsets_.release();
+            begin=end;
+        }
+        pre_offsets_.map(false);
+        pre_.map(false);
+    }
+};/* end of class definition */
+}/* end of namespace negotiation */
+#endif
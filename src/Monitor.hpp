@@ -11,11 +11,19 @@
 #include <queue>
 #include <bits/stdc++.h>
 #include <unordered_set>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <cstdint>
 
 #include "Component.hpp" /* for the definition of data types abs_type and abs_ptr_type */
+#include "Arena.hpp"
+#include "MappedTransitions.hpp"
 
 /** @namespace negotiation **/
 namespace negotiation {
+/** @brief unordered set of state or input indices whose memory comes from an Arena **/
+typedef std::unordered_set<abs_type, std::hash<abs_type>, std::equal_to<abs_type>, ArenaAllocator<abs_type>> arena_set;
 /**
  *  @class Monitor
  *
@@ -23,6 +31,12 @@ namespace negotiation {
  *
  * The monitor is made up of finitely many states, and the transitions between the states are labeled with tuples of (control input, disturbance inputs). The transitions can in general be non-deterministic due to external environmental effects.
  * The state 0 is assumed to be the "reject_A" and the state 1 is assumed to be the "reject_G" state.
+ *
+ * The transition sets of the monitor, and all the sets computed by the games derived from it, are allocated from the arena arena_. Copies of a monitor share the arena, and everything is freed at once when the last monitor using it is destroyed.
+ *
+ * The pre and post sets are not modified once they are built (except by trim, which builds new ones), and copies of a monitor share them. The transitions are removed and restored through the overlay enabled_ instead: the transitions of a disabled state-input triple are treated as absent, and its no_post is 0.
+ *
+ * For products which do not fit into the memory, the transitions can instead be stored in memory-mapped temporary files (see MappedTransitions and the corresponding constructor); then pre and post are nullptr. The transitions should always be read through for_each_pre, for_each_post, any_pre, post_size and has_post, which work with both kinds of storage.
 **/
 class Monitor {
 public:
@@ -43,17 +57,33 @@ public:
     /** @brief number of internal disturbance inputs P **/
     abs_type no_dist_inputs;
     /** @brief array containing the list of all pre: pre[i*M*P + j*P + k] lists all pres for the state, control input, dist input pair (i,j,k) */
-    std::unordered_set<abs_type>** pre;
+    arena_set** pre;
     /** @brief array containing the list of all posts: post[i*M*P + j*P + k] lists all posts for the state, control input, dist input pair (i,j,k) */
-    std::unordered_set<abs_type>** post;
-    /** @brief vector[N*M*P] saving the number of post for each pair (i,j,k) **/
-    std::vector<abs_type> no_post;
+    arena_set** post;
+    /** @brief vector[N*M*P] of enable bits for each pair (i,j,k): the posts of (i,j,k) are only present when the bit is set **/
+    std::vector<bool> enabled_;
     /** @brief a guard flag that tells whether the monitor state indices were relabeled **/
     bool monitor_states_were_relabeled;
+    /** @brief the arena holding pre, post and the sets computed by the games **/
+    std::shared_ptr<Arena> arena_;
+    /** @brief the number of threads used by the game solvers (1 by default; see solve_attractor) **/
+    int no_threads_;
+    /** @brief frontiers smaller than this are expanded by the calling thread alone, also when no_threads_>1 (4096 by default; see solve_attractor and compute_reachable_bitset) **/
+    size_t min_parallel_frontier_;
+    /** @brief the transitions stored in memory-mapped files (nullptr when they are stored in pre and post) **/
+    std::shared_ptr<MappedTransitions> mapped_;
+private:
+    /** @brief reusable buffers of compute_reachable_bitset: the visited bitset, the bitset of the current bottom-up level, the frontiers, and the per-thread successor buffers **/
+    std::vector<std::uint64_t> reach_bits_, reach_next_bits_;
+    std::vector<abs_type> reach_frontier_, reach_next_;
+    std::vector<std::vector<abs_type>> reach_local_;
 public:
     /*! Copy constructor
      * \param[in] other   The monitor whose attributes are to be copied*/
     Monitor(const Monitor& other) {
+        arena_=other.arena_;
+        no_threads_=other.no_threads_;
+        min_parallel_frontier_=other.min_parallel_frontier_;
         no_states=other.no_states;
         init_=other.init_;
         no_comp_states=other.no_comp_states;
@@ -64,48 +94,32 @@ public:
         no_guarantee_states=other.no_guarantee_states;
         no_control_inputs=other.no_control_inputs;
         no_dist_inputs=other.no_dist_inputs;
-        abs_type size = no_states*no_control_inputs*no_dist_inputs;
-        pre = new std::unordered_set<abs_type>*[size];
-        for (abs_type i=0; i<size; i++) {
-            std::unordered_set<abs_type>* v=new std::unordered_set<abs_type>;
-            pre[i]=v;
-            for (auto j=other.pre[i]->begin(); j!=other.pre[i]->end(); ++j) {
-                pre[i]->insert(*j);
-            }
-        }
-        post = new std::unordered_set<abs_type>*[size];
-        for (abs_type i=0; i<size; i++) {
-            std::unordered_set<abs_type>* s=new std::unordered_set<abs_type>;
-            post[i]=s;
-            for (auto j=other.post[i]->begin(); j!=other.post[i]->end(); ++j) {
-                post[i]->insert(*j);
-            }
-        }
-        no_post=other.no_post;
+        /* the transition sets are immutable and are shared; only the overlay is copied */
+        pre=other.pre;
+        post=other.post;
+        mapped_=other.mapped_;
+        enabled_=other.enabled_;
         monitor_states_were_relabeled=other.monitor_states_were_relabeled;
     }
-    /*! Destructor */
-    ~Monitor() {
-        delete[] pre;
-        delete[] post;
-    }
-    /*! Constructor: the allowed_inputs is a vector of allowed_inputs of the *monitor states* */
-    Monitor(Component& comp, SafetyAutomaton& assume, SafetyAutomaton& guarantee, std::vector<std::unordered_set<abs_type>*>& allowed_control_inputs, std::vector<std::unordered_set<abs_type>*>& allowed_joint_inputs) {
+    /*! Destructor: pre and post are freed together with the arena */
+    ~Monitor() {}
+    /*! Constructor: the allowed_inputs is a vector of allowed_inputs of the *monitor states*
+     * \param[in] arena    [Optional] the arena to allocate from (a new one is created by default) */
+    Monitor(Component& comp, SafetyAutomaton& assume, SafetyAutomaton& guarantee, std::vector<arena_set*>& allowed_control_inputs, std::vector<arena_set*>& allowed_joint_inputs, std::shared_ptr<Arena> arena=std::shared_ptr<Arena>()) : arena_(arena ? arena : std::make_shared<Arena>()), no_threads_(1), min_parallel_frontier_(4096) {
         initialize(comp, assume, guarantee);
         ComputeTransitions(comp, assume, guarantee, allowed_control_inputs, allowed_joint_inputs);
     }
-    /*! Constructor without allowed inputs */
-    Monitor(Component& comp, SafetyAutomaton& assume, SafetyAutomaton& guarantee) {
+    /*! Constructor without allowed inputs
+     * \param[in] arena    [Optional] the arena to allocate from (a new one is created by default) */
+    Monitor(Component& comp, SafetyAutomaton& assume, SafetyAutomaton& guarantee, std::shared_ptr<Arena> arena=std::shared_ptr<Arena>()) : arena_(arena ? arena : std::make_shared<Arena>()), no_threads_(1), min_parallel_frontier_(4096) {
         initialize(comp, assume, guarantee);
-        std::vector<std::unordered_set<abs_type>*> allowed_control_inputs, allowed_joint_inputs;
+        std::vector<arena_set*> allowed_control_inputs, allowed_joint_inputs;
         /* allow all inputs */
-        std::unordered_set<abs_type> all_control_inputs, all_joint_inputs;
+        arena_set all_control_inputs, all_joint_inputs;
         for (abs_type j=0; j<comp.no_control_inputs; j++)
             all_control_inputs.insert(j);
         for (abs_type im=0; im<no_states; im++) {
-            std::unordered_set<abs_type>* s = new std::unordered_set<abs_type>;
-            *s=all_control_inputs;
-            allowed_control_inputs.push_back(s);
+            allowed_control_inputs.push_back(new_set(all_control_inputs));
         }
         for (abs_type j=0; j<comp.no_control_inputs; j++) {
             for (abs_type k=0; k<comp.no_dist_inputs; k++) {
@@ -113,12 +127,32 @@ public:
             }
         }
         for (abs_type im=0; im<no_states; im++) {
-            std::unordered_set<abs_type>* s = new std::unordered_set<abs_type>;
-            *s=all_joint_inputs;
-            allowed_joint_inputs.push_back(s);
+            allowed_joint_inputs.push_back(new_set(all_joint_inputs));
         }
         ComputeTransitions(comp, assume, guarantee, allowed_control_inputs, allowed_joint_inputs);
     }
+    /*! Constructor: incremental update of a monitor after the assumption and the guarantee were refined.
+     *
+     * The states of the new automata are matched with the states of the old ones (see SafetyAutomaton::matchStates). The monitor states whose assumption and guarantee states are matched, and have transitions corresponding to the ones of their matches, take over the transitions of the old monitor with relabeled posts; the transitions of the rest are computed as usual. The whole product is computed as usual when less than half of the monitor states can be taken over.
+     * \param[in] old               the monitor built for the same component and for old_assume and old_guarantee, without allowed inputs (its states must not have been relabeled by trim)
+     * \param[in] old_assume        the assumption of the old monitor
+     * \param[in] old_guarantee     the guarantee of the old monitor
+     * \param[in] comp              the component
+     * \param[in] assume            the new assumption
+     * \param[in] guarantee         the new guarantee
+     * \param[in] arena             [Optional] the arena to allocate from (a new one is created by default) */
+    Monitor(Monitor& old, SafetyAutomaton& old_assume, SafetyAutomaton& old_guarantee, Component& comp, SafetyAutomaton& assume, SafetyAutomaton& guarantee, std::shared_ptr<Arena> arena=std::shared_ptr<Arena>()) : arena_(arena ? arena : std::make_shared<Arena>()), no_threads_(1), min_parallel_frontier_(4096) {
+        initialize(comp, assume, guarantee);
+        UpdateTransitions(old, old_assume, old_guarantee, comp, assume, guarantee);
+    }
+    /*! Constructor without allowed inputs, storing the transitions in memory-mapped temporary files (see MapTransitions)
+     * \param[in] dir               the directory of the temporary files
+     * \param[in] memory_budget     the resident memory used for building the pre array, in bytes
+     * \param[in] arena             [Optional] the arena to allocate from (a new one is created by default) */
+    Monitor(Component& comp, SafetyAutomaton& assume, SafetyAutomaton& guarantee, const std::string& dir, const size_t memory_budget, std::shared_ptr<Arena> arena=std::shared_ptr<Arena>()) : arena_(arena ? arena : std::make_shared<Arena>()), no_threads_(1), min_parallel_frontier_(4096) {
+        initialize(comp, assume, guarantee);
+        MapTransitions(comp, assume, guarantee, dir, memory_budget);
+    }
     /*! Function to initialize all non-transition related members */
     void initialize(Component& comp, SafetyAutomaton& assume, SafetyAutomaton& guarantee) {
         /* sanity check */
@@ -140,10 +174,14 @@ public:
         monitor_states_were_relabeled=false;
         /* compute the product */
        /* number of states is Nc*(Na-1)*(Ng-1)+2 */
-        no_states=comp.no_states*(assume.no_states_-1)*(guarantee.no_states_-1)+2;
+        no_states=abs_type(checked_product({comp.no_states,assume.no_states_-1,guarantee.no_states_-1},std::numeric_limits<abs_type>::max()-2,"Monitor: the number of monitor states")+2);
+        /* the addresses of the state-input triples are of type abs_ptr_type */
+        checked_product({no_states,comp.no_control_inputs,comp.no_dist_inputs},std::numeric_limits<size_t>::max()/sizeof(arena_set*),"Monitor: the number of state-input triples");
+        checked_product({comp.no_control_inputs,comp.no_dist_inputs},std::numeric_limits<abs_type>::max(),"Monitor: the number of joint inputs");
         no_comp_states=comp.no_states;
         no_assume_states=assume.no_states_;
         no_guarantee_states=guarantee.no_states_;
+        monitor_to_component_state_id.reserve(no_states);
         for (abs_type im=0; im<no_states; im++) {
             /* the monitor states 0,1 do not correspond to any component state, and are mapped to infinity */
             if (im==0 || im==1) {
@@ -158,7 +196,7 @@ public:
              /* the output label of the initial component state is used to initialize the guarantee automaton */
              abs_type o=comp.state_to_output[*i];
              for (auto k=guarantee.init_.begin(); k!=guarantee.init_.end(); ++k) {
-                 std::unordered_set<abs_type>* p = guarantee.post_[guarantee.addr(*k,o)];
+                 const std::unordered_set<abs_type>* p = &guarantee.post_[guarantee.addr(*k,o)];
                  for (auto k2=p->begin(); k2!=p->end(); ++k2) {
                      for (auto j=assume.init_.begin(); j!=assume.init_.end(); ++j) {
                          init_.insert(monitor_state_ind(*i,*j,*k2,no_assume_states,no_guarantee_states));
@@ -169,7 +207,7 @@ public:
         no_control_inputs=comp.no_control_inputs;
         no_dist_inputs=comp.no_dist_inputs;
     }
-    /*! Fill up the pre, post, and no_post arrays
+    /*! Fill up the pre and post arrays
      * \param[in] comp      the component
      * \param[in] assume    the assumption safety automaton
      * \param[in] guarantee the guarantee safety automaton
@@ -177,202 +215,503 @@ public:
      * \param[in] allowed_joint_inputs      the set of allowed joint control strategies
      *
      * NOTE: the vectors allowed_control_inputs and allowed_joint_inputs have to be of the same size as the number of monitor states, i.e. equal to (#component states)*(#assume states - 1)*(#guarantee states - 1) + 2 */
-    void ComputeTransitions(Component& comp, SafetyAutomaton& assume, SafetyAutomaton& guarantee, std::vector<std::unordered_set<abs_type>*>& allowed_control_inputs, std::vector<std::unordered_set<abs_type>*>& allowed_joint_inputs) {
+    void ComputeTransitions(Component& comp, SafetyAutomaton& assume, SafetyAutomaton& guarantee, std::vector<arena_set*>& allowed_control_inputs, std::vector<arena_set*>& allowed_joint_inputs) {
         /* sanity check */
         if (allowed_control_inputs.size()!=no_states
             || allowed_joint_inputs.size()!=no_states) {
             throw std::runtime_error("Monitor::ComputeTransitions: the size of allowed inputs do not match with the number of monitor states.\n");
         }
-        no_post.assign(no_states*no_control_inputs*no_dist_inputs,0);
-        /* the reject states are sink states */
-        for (abs_type i=0; i<=1; i++) {
-            for (abs_type j=0; j<no_control_inputs; j++) {
-                for (abs_type k=0; k<no_dist_inputs; k++) {
-                    no_post[addr_xuw(i,j,k)]=1;
+        allocateTransitions();
+        for (abs_type ic=0; ic<comp.no_states; ic++) {
+            for (abs_type ia=1; ia<no_assume_states; ia++) {
+                for (abs_type ig=1; ig<no_guarantee_states; ig++) {
+                    /* the pre state index for the tuple (ic,ia,ig)*/
+                    abs_type im = monitor_state_ind(ic,ia,ig,no_assume_states,no_guarantee_states);
+                    addTransitions(comp,assume,guarantee,ic,ia,ig,allowed_control_inputs[im],allowed_joint_inputs[im]);
                 }
             }
         }
-        /* compute and store the predecessors, successors, valid inputs, and valid joint inputs for fast synthesis */
-        pre=new std::unordered_set<abs_type>*[no_states*no_control_inputs*no_dist_inputs];
-        post=new std::unordered_set<abs_type>*[no_states*no_control_inputs*no_dist_inputs];
-        for (abs_type i=0; i<no_states*no_control_inputs*no_dist_inputs; i++) {
-            std::unordered_set<abs_type> *v=new std::unordered_set<abs_type>;
-            pre[i]=v;
-            std::unordered_set<abs_type>* s=new std::unordered_set<abs_type>;
-            post[i]=s;
+        addRejectSelfLoops();
+    }
+    /*! Update the transitions for a new assumption and a new guarantee, starting from a monitor built for older versions of them (see the corresponding constructor)
+     * \param[in] old               the old monitor
+     * \param[in] old_assume        the assumption of the old monitor
+     * \param[in] old_guarantee     the guarantee of the old monitor
+     * \param[in] comp              the component (the same as the one of the old monitor)
+     * \param[in] assume            the new assumption
+     * \param[in] guarantee         the new guarantee
+     * \return                      the number of monitor states whose transitions were relabeled from the old monitor */
+    abs_type UpdateTransitions(Monitor& old, SafetyAutomaton& old_assume, SafetyAutomaton& old_guarantee, Component& comp, SafetyAutomaton& assume, SafetyAutomaton& guarantee) {
+        /* invariant: match is injective (matchStates pairs states one-to-one), and inverse is its inverse on the matched old states.
+         * A new state i is clean when, for every input x, match maps post(i,x) into post_old(match[i],x) and both have the same size; by injectivity match is then a bijection between the two post sets.
+         * Hence every post of a clean old state has a preimage, and relabeling the old monitor posts of (ic,match[ia],match[ig]) through inverse gives exactly the new posts of (ic,ia,ig): the component part is unchanged, and the automaton parts are the images of these bijections. */
+        /* the new automaton states whose transitions correspond to the ones of their matched old states */
+        auto clean_states = [](SafetyAutomaton& A, SafetyAutomaton& A_old, std::vector<abs_type>& match, std::vector<abs_type>& inverse) -> std::vector<bool> {
+            match=A.matchStates(A_old);
+            inverse.assign(A_old.no_states_,A.no_states_);
+            for (abs_type i=0; i<A.no_states_; i++) {
+                if (match[i]<A_old.no_states_) {
+                    inverse[match[i]]=i;
+                }
+            }
+            std::vector<bool> clean(A.no_states_,false);
+            for (abs_type i=1; i<A.no_states_; i++) {
+                if (match[i]==A_old.no_states_) {
+                    continue;
+                }
+                clean[i]=true;
+                for (abs_type x=0; x<A.no_inputs_ && clean[i]; x++) {
+                    const std::unordered_set<abs_type>& p=A.post_[A.addr(i,x)];
+                    const std::unordered_set<abs_type>& p_old=A_old.post_[A_old.addr(match[i],x)];
+                    if (p.size()!=p_old.size()) {
+                        clean[i]=false;
+                    }
+                    for (auto i2=p.begin(); i2!=p.end() && clean[i]; ++i2) {
+                        if (match[*i2]==A_old.no_states_ || p_old.find(match[*i2])==p_old.end()) {
+                            clean[i]=false;
+                        }
+                    }
+                }
+            }
+            return clean;
+        };
+        std::vector<abs_type> match_a, inverse_a, match_g, inverse_g;
+        std::vector<bool> clean_a, clean_g;
+        abs_type no_clean_a=0, no_clean_g=0;
+        bool compatible=(!old.monitor_states_were_relabeled &&
+                         old.no_comp_states==comp.no_states &&
+                         old.no_control_inputs==no_control_inputs &&
+                         old.no_dist_inputs==no_dist_inputs &&
+                         old.no_assume_states==old_assume.no_states_ &&
+                         old.no_guarantee_states==old_guarantee.no_states_);
+        if (compatible) {
+            clean_a=clean_states(assume,old_assume,match_a,inverse_a);
+            clean_g=clean_states(guarantee,old_guarantee,match_g,inverse_g);
+            no_clean_a=std::count(clean_a.begin(),clean_a.end(),true);
+            no_clean_g=std::count(clean_g.begin(),clean_g.end(),true);
         }
+        /* relabel only if at least half of the monitor states can be relabeled; otherwise the matching is not worth its bookkeeping */
+        bool reuse=(compatible && 2*no_clean_a*no_clean_g>=(no_assume_states-1)*(no_guarantee_states-1));
+        allocateTransitions();
+        abs_type no_reused=0;
         for (abs_type ic=0; ic<comp.no_states; ic++) {
             for (abs_type ia=1; ia<no_assume_states; ia++) {
                 for (abs_type ig=1; ig<no_guarantee_states; ig++) {
-                    /* the pre state index for the tuple (ic,ia,ig)*/
-                    abs_type im = monitor_state_ind(ic,ia,ig,no_assume_states,no_guarantee_states);
+                    if (!reuse || !clean_a[ia] || !clean_g[ig]) {
+                        addTransitions(comp,assume,guarantee,ic,ia,ig,nullptr,nullptr);
+                        continue;
+                    }
+                    no_reused++;
+                    abs_type im=monitor_state_ind(ic,ia,ig,no_assume_states,no_guarantee_states);
+                    abs_type im_old=old.monitor_state_ind(ic,match_a[ia],match_g[ig],old.no_assume_states,old.no_guarantee_states);
                     for (abs_type j=0; j<no_control_inputs; j++) {
-                        /* if there is a control strategy, and the current control input is not allowed, then continue with the next one */
-                        if ((allowed_control_inputs[im]->size()!=0) &&
-                            (allowed_control_inputs[im]->find(j)==allowed_control_inputs[im]->end())) {
-                            continue;
-                        }
                         for (abs_type k=0; k<no_dist_inputs; k++) {
-                            /* if the current joint control input is not allowed, then continue with the next disturbance input */
-                            if (allowed_joint_inputs[im]->find(addr_uw(j,k))== allowed_joint_inputs[im]->end()) {
-                                continue;
-                            }
-                            /* if the assume automaton has hit a deadend, then ignore the current disturbance input */
-                            if ((assume.post_[assume.addr(ia,k)])->size()==0) {
-                                continue;
-                            }
-                            /* if any of the non-deterministic successors of the assumption automata is rejecting, then this is counted as a rejecting assumption */
-                            bool is_assume_reject=false;
-                            for (auto ia2=(assume.post_[assume.addr(ia,k)])->begin(); ia2!= (assume.post_[assume.addr(ia,k)])->end(); ++ia2) {
-                                if (*ia2==0) {
-                                    is_assume_reject=true;
-                                    break;
+                            old.for_each_post(old.addr_xuw(im_old,j,k),[&](abs_type im2) {
+                                /* the reject states keep their indices, and the posts of the rest are relabeled through the matchings */
+                                if (im2>=2) {
+                                    abs_type ic2=(im2-2)/((old.no_assume_states-1)*(old.no_guarantee_states-1));
+                                    abs_type ia2=((im2-2)/(old.no_guarantee_states-1))%(old.no_assume_states-1)+1;
+                                    abs_type ig2=(im2-2)%(old.no_guarantee_states-1)+1;
+                                    im2=monitor_state_ind(ic2,inverse_a[ia2],inverse_g[ig2],no_assume_states,no_guarantee_states);
                                 }
-                            }
-                            /* non-deterministic post assumption states */
-                            for (auto ia2=(assume.post_[assume.addr(ia,k)])->begin(); ia2!= (assume.post_[assume.addr(ia,k)])->end(); ++ia2) {
-                                /* non-deterministic component successor states */
-                                for (auto ic2 = comp.post[comp.addr(ic,j,k)]->begin() ; ic2 != comp.post[comp.addr(ic,j,k)]->end(); ++ic2) {
-                                    /* if the guarantee automaton reached a deadend, then ignore the current component successor state */
-                                    if ((guarantee.post_[guarantee.addr(ig,comp.state_to_output[*ic2])])->size()==0) {
-                                        continue;
-                                    }
-                                    /* if any of the non-deterministic successors of the guarantee automata is rejecting, then this is counting as a rejecting guarantee */
-                                    bool is_guarantee_reject=false;
-                                    for (auto ig2=(guarantee.post_[guarantee.addr(ig,comp.state_to_output[*ic2])])->begin(); ig2!=(guarantee.post_[guarantee.addr(ig,comp.state_to_output[*ic2])])->end(); ++ig2) {
-                                        if (*ig2==0) {
-                                            is_guarantee_reject=true;
-                                            break;
-                                        }
-                                    }
-                                    /* if either the assumption or the guarantee hit the bad state, then the monitor goes to one of the sink states and no other transitions are added */
-                                    if (is_assume_reject) {
-                                        if (post[addr_xuw(im,j,k)]->find(0) == post[addr_xuw(im,j,k)]->end()) {
-                                            pre[addr_xuw(0,j,k)]->insert(im);
-                                            post[addr_xuw(im,j,k)]->insert(0);
-                                            no_post[addr_xuw(im,j,k)]++;
-                                        }
-                                        continue;
-                                    } else if (is_guarantee_reject) {
-                                        if (post[addr_xuw(im,j,k)]->find(1) == post[addr_xuw(im,j,k)]->end()) {
-                                            pre[addr_xuw(1,j,k)]->insert(im);
-                                            post[addr_xuw(im,j,k)]->insert(1);
-                                            no_post[addr_xuw(im,j,k)]++;
-                                        }
-                                        continue;
-                                    }
-                                    /* add non-deterministic guarantee successor states */
-                                    for (auto ig2=(guarantee.post_[guarantee.addr(ig,comp.state_to_output[*ic2])])->begin(); ig2!=(guarantee.post_[guarantee.addr(ig,comp.state_to_output[*ic2])])->end(); ++ig2) {
-                                        /* the post state tuple index */
-                                        abs_type im2 = monitor_state_ind(*ic2,*ia2,*ig2,no_assume_states,no_guarantee_states);
-                                        if (post[addr_xuw(im,j,k)]->find(im2) == post[addr_xuw(im,j,k)]->end()) {
-                                            no_post[addr_xuw(im,j,k)]++;
-                                            pre[addr_xuw(im2,j,k)]->insert(im);
-                                            post[addr_xuw(im,j,k)]->insert(im2);
-                                        }
-                                    }
+                                if (post[addr_xuw(im,j,k)]->insert(im2).second) {
+                                    pre[addr_xuw(im2,j,k)]->insert(im);
                                 }
-                            }
+                            });
                         }
                     }
                 }
             }
         }
-        /* self loops to the reject states */
+        addRejectSelfLoops();
+        return no_reused;
+    }
+    /*! Compute the transitions (without allowed inputs) into memory-mapped temporary files.
+     *
+     * The posts are computed state by state in the order of the addresses, and are written out right away, so that only the posts of one monitor state are held in memory; the pre array is then built from the files (see MappedTransitions). Only the enable bits stay in memory, and they are counted against the memory budget.
+     * \param[in] comp              the component
+     * \param[in] assume            the assumption safety automaton
+     * \param[in] guarantee         the guarantee safety automaton
+     * \param[in] dir               the directory of the temporary files
+     * \param[in] memory_budget     the resident memory used for the enable bits and for building the pre array, in bytes */
+    void MapTransitions(Component& comp, SafetyAutomaton& assume, SafetyAutomaton& guarantee, const std::string& dir, const size_t memory_budget) {
+        const abs_type no_inputs=no_control_inputs*no_dist_inputs;
+        /* the enable bits take one bit per triple out of the budget */
+        const size_t enabled_bytes=(abs_ptr_type(no_states)*no_inputs+7)/8;
+        if (enabled_bytes>=memory_budget) {
+            throw std::runtime_error("Monitor:MapTransitions: the enable bits of the monitor do not fit into the memory budget.");
+        }
+        enabled_.assign(abs_ptr_type(no_states)*no_inputs,true);
+        pre=nullptr;
+        post=nullptr;
+        mapped_=std::make_shared<MappedTransitions>(dir,size_t(no_states)*no_inputs,no_inputs,memory_budget-enabled_bytes);
+        std::vector<std::vector<abs_type>> posts(no_inputs);
+        for (abs_type im=0; im<no_states; im++) {
+            for (abs_type l=0; l<no_inputs; l++) {
+                posts[l].clear();
+            }
+            if (im<=1) {
+                /* the reject states are sink states */
+                for (abs_type l=0; l<no_inputs; l++) {
+                    posts[l].push_back(im);
+                }
+            } else {
+                abs_type ic=component_state_ind(im);
+                abs_type ia=((im-2)/(no_guarantee_states-1))%(no_assume_states-1)+1;
+                abs_type ig=(im-2)%(no_guarantee_states-1)+1;
+                forEachTransition(comp,assume,guarantee,ic,ia,ig,nullptr,nullptr,[&](const abs_type j, const abs_type k, const abs_type im2) {
+                    posts[addr_uw(j,k)].push_back(im2);
+                });
+                for (abs_type l=0; l<no_inputs; l++) {
+                    std::sort(posts[l].begin(),posts[l].end());
+                    posts[l].erase(std::unique(posts[l].begin(),posts[l].end()),posts[l].end());
+                }
+            }
+            for (abs_type l=0; l<no_inputs; l++) {
+                mapped_->append_post(posts[l]);
+            }
+        }
+        mapped_->finish();
+    }
+    /*! Allocate the pre and post arrays, and reset the enable bits */
+    void allocateTransitions() {
+        enabled_.assign(abs_ptr_type(no_states)*no_control_inputs*no_dist_inputs,true);
+        /* compute and store the predecessors, successors, valid inputs, and valid joint inputs for fast synthesis */
+        pre=new_set_array(abs_ptr_type(no_states)*no_control_inputs*no_dist_inputs);
+        post=new_set_array(abs_ptr_type(no_states)*no_control_inputs*no_dist_inputs);
+        for (abs_ptr_type i=0; i<abs_ptr_type(no_states)*no_control_inputs*no_dist_inputs; i++) {
+            pre[i]=new_set();
+            post[i]=new_set();
+        }
+    }
+    /*! Add the self loops of the reject states */
+    void addRejectSelfLoops() {
         for (abs_type j=0; j<no_control_inputs; j++) {
             for (abs_type k=0; k<no_dist_inputs; k++) {
                 pre[addr_xuw(0,j,k)]->insert(0);
                 pre[addr_xuw(1,j,k)]->insert(1);
                 post[addr_xuw(0,j,k)]->insert(0);
                 post[addr_xuw(1,j,k)]->insert(1);
-                no_post[addr_xuw(0,j,k)]++;
-                no_post[addr_xuw(1,j,k)]++;
             }
         }
     }
-    /*! Compue the set of states reachable from the initial states
-     * \param[out] set  The set of state indices reachable from the initial states*/
-    std::unordered_set<abs_type> compute_reachable_set() {
-        /* the queue of states whose successors are to be explored */
-        std::queue<abs_type> fifo;
-        /* states already seen */
-        std::unordered_set<abs_type> seen;
-        /* initialize the queue and seen with the set of initial states */
+    /*! Add the transitions of the monitor state (ic,ia,ig) to the pre and post arrays (see ComputeTransitions)
+     * \param[in] comp      the component
+     * \param[in] assume    the assumption safety automaton
+     * \param[in] guarantee the guarantee safety automaton
+     * \param[in] ic        the component state
+     * \param[in] ia        the assumption state (other than the reject state)
+     * \param[in] ig        the guarantee state (other than the reject state)
+     * \param[in] allowed_control   the allowed control inputs (all when nullptr or empty)
+     * \param[in] allowed_joint     the allowed joint inputs (all when nullptr) */
+    void addTransitions(Component& comp, SafetyAutomaton& assume, SafetyAutomaton& guarantee, const abs_type ic, const abs_type ia, const abs_type ig, const arena_set* allowed_control, const arena_set* allowed_joint) {
+        abs_type im = monitor_state_ind(ic,ia,ig,no_assume_states,no_guarantee_states);
+        forEachTransition(comp,assume,guarantee,ic,ia,ig,allowed_control,allowed_joint,[&](const abs_type j, const abs_type k, const abs_type im2) {
+            if (post[addr_xuw(im,j,k)]->insert(im2).second) {
+                pre[addr_xuw(im2,j,k)]->insert(im);
+            }
+        });
+    }
+    /*! Visit the transitions of the monitor state (ic,ia,ig), possibly several times each (see addTransitions)
+     * \param[in] comp      the component
+     * \param[in] assume    the assumption safety automaton
+     * \param[in] guarantee the guarantee safety automaton
+     * \param[in] ic        the component state
+     * \param[in] ia        the assumption state (other than the reject state)
+     * \param[in] ig        the guarantee state (other than the reject state)
+     * \param[in] allowed_control   the allowed control inputs (all when nullptr or empty)
+     * \param[in] allowed_joint     the allowed joint inputs (all when nullptr)
+     * \param[in] f         called with (j,k,im2) for every transition to the state im2 under the control input j and the disturbance input k */
+    template<class F>
+    void forEachTransition(Component& comp, SafetyAutomaton& assume, SafetyAutomaton& guarantee, const abs_type ic, const abs_type ia, const abs_type ig, const arena_set* allowed_control, const arena_set* allowed_joint, F f) {
+        for (abs_type j=0; j<no_control_inputs; j++) {
+            /* if there is a control strategy, and the current control input is not allowed, then continue with the next one */
+            if (allowed_control!=nullptr && (allowed_control->size()!=0) &&
+                (allowed_control->find(j)==allowed_control->end())) {
+                continue;
+            }
+            for (abs_type k=0; k<no_dist_inputs; k++) {
+                /* if the current joint control input is not allowed, then continue with the next disturbance input */
+                if (allowed_joint!=nullptr && allowed_joint->find(addr_uw(j,k))==allowed_joint->end()) {
+                    continue;
+                }
+                /* if the assume automaton has hit a deadend, then ignore the current disturbance input */
+                if ((assume.post_[assume.addr(ia,k)]).size()==0) {
+                    continue;
+                }
+                /* if any of the non-deterministic successors of the assumption automata is rejecting, then this is counted as a rejecting assumption */
+                bool is_assume_reject=false;
+                for (auto ia2=(assume.post_[assume.addr(ia,k)]).begin(); ia2!= (assume.post_[assume.addr(ia,k)]).end(); ++ia2) {
+                    if (*ia2==0) {
+                        is_assume_reject=true;
+                        break;
+                    }
+                }
+                /* non-deterministic post assumption states */
+                for (auto ia2=(assume.post_[assume.addr(ia,k)]).begin(); ia2!= (assume.post_[assume.addr(ia,k)]).end(); ++ia2) {
+                    /* non-deterministic component successor states */
+                    for (auto ic2 = comp.post[comp.addr(ic,j,k)]->begin() ; ic2 != comp.post[comp.addr(ic,j,k)]->end(); ++ic2) {
+                        /* if the guarantee automaton reached a deadend, then ignore the current component successor state */
+                        if ((guarantee.post_[guarantee.addr(ig,comp.state_to_output[*ic2])]).size()==0) {
+                            continue;
+                        }
+                        /* if any of the non-deterministic successors of the guarantee automata is rejecting, then this is counting as a rejecting guarantee */
+                        bool is_guarantee_reject=false;
+                        for (auto ig2=(guarantee.post_[guarantee.addr(ig,comp.state_to_output[*ic2])]).begin(); ig2!=(guarantee.post_[guarantee.addr(ig,comp.state_to_output[*ic2])]).end(); ++ig2) {
+                            if (*ig2==0) {
+                                is_guarantee_reject=true;
+                                break;
+                            }
+                        }
+                        /* if either the assumption or the guarantee hit the bad state, then the monitor goes to one of the sink states and no other transitions are added */
+                        if (is_assume_reject) {
+                            f(j,k,0);
+                            continue;
+                        } else if (is_guarantee_reject) {
+                            f(j,k,1);
+                            continue;
+                        }
+                        /* add non-deterministic guarantee successor states */
+                        for (auto ig2=(guarantee.post_[guarantee.addr(ig,comp.state_to_output[*ic2])]).begin(); ig2!=(guarantee.post_[guarantee.addr(ig,comp.state_to_output[*ic2])]).end(); ++ig2) {
+                            /* the post state tuple index */
+                            f(j,k,monitor_state_ind(*ic2,*ia2,*ig2,no_assume_states,no_guarantee_states));
+                        }
+                    }
+                }
+            }
+        }
+    }
+    /*! Compute the set of states reachable from the initial states by a direction-optimizing breadth-first search over the enabled transitions.
+     *
+     * A level is expanded top-down (the frontier states push their successors) while the frontier is small compared to the unvisited states, and bottom-up (every unvisited state looks for a visited predecessor over pre) while it is large. Levels of at least min_parallel_frontier_ states are processed by no_threads_ threads. The visited bitset and the frontiers are member buffers, so that no allocation happens once they have grown to the size of the state space.
+     * \param[out] bitset  The visited bitset with one bit per state index (query with is_reachable); valid until the next call */
+    const std::vector<std::uint64_t>& compute_reachable_bitset() {
+        /* number of frontier states (top-down) or bitset words (bottom-up) taken by a thread at once */
+        const size_t grain=64;
+        /* switch to bottom-up when the frontier is larger than the unvisited states divided by alpha, and back to top-down when it is smaller than the state space divided by beta */
+        const size_t alpha=14, beta=24;
+        const size_t no_words=(no_states+63)/64;
+        reach_bits_.assign(no_words,0);
+        reach_frontier_.clear();
         for (auto i=init_.begin(); i!=init_.end(); ++i) {
-            fifo.push(*i);
-            seen.insert(*i);
-        }
-        /* until no new states are found */
-        while (fifo.size()!=0) {
-            /* pop the front element */
-            abs_type i = fifo.front();
-            fifo.pop();
-            /* add all the successors of i to the queue */
-            for (abs_type j=0; j<no_control_inputs; j++) {
-                for (abs_type k=0; k<no_dist_inputs; k++) {
-                    /* address in the post array */
-                    abs_type post_addr = addr_xuw(i,j,k);
-                    for (auto i2=post[post_addr]->begin(); i2!=post[post_addr]->end(); ++i2) {
-                        /* if the state i2 is not seen, then add i2 to the queue and seen */
-                        if (seen.find(*i2)==seen.end()) {
-                            fifo.push(*i2);
-                            seen.insert(*i2);
+            if (!is_reachable(*i)) {
+                reach_bits_[*i>>6]|=(std::uint64_t(1)<<(*i&63));
+                reach_frontier_.push_back(*i);
+            }
+        }
+        const int no_threads=std::max(no_threads_,1);
+        reach_local_.resize(no_threads);
+        size_t no_visited=reach_frontier_.size();
+        bool bottom_up=false;
+        while (reach_frontier_.size()!=0) {
+            if (!bottom_up && reach_frontier_.size()*alpha>no_states-no_visited) {
+                bottom_up=true;
+            } else if (bottom_up && reach_frontier_.size()*beta<no_states) {
+                bottom_up=false;
+            }
+            std::atomic<size_t> cursor(0);
+            /* top-down: collect the unvisited successors of the frontier in thread-local buffers; the bitset is only read */
+            auto expand_top_down = [&](const int t) {
+                while (true) {
+                    size_t begin=cursor.fetch_add(grain);
+                    if (begin>=reach_frontier_.size()) {
+                        break;
+                    }
+                    size_t end=std::min(begin+grain,reach_frontier_.size());
+                    for (size_t n=begin; n<end; n++) {
+                        abs_type i=reach_frontier_[n];
+                        for (abs_type j=0; j<no_control_inputs; j++) {
+                            for (abs_type k=0; k<no_dist_inputs; k++) {
+                                abs_ptr_type post_addr=addr_xuw(i,j,k);
+                                if (!enabled_[post_addr]) {
+                                    continue;
+                                }
+                                for_each_post(post_addr,[&](const abs_type i2) {
+                                    if (!is_reachable(i2)) {
+                                        reach_local_[t].push_back(i2);
+                                    }
+                                });
+                            }
                         }
                     }
                 }
+            };
+            /* bottom-up: every thread owns whole words of the next level's bitset, and marks the unvisited states of its words with a visited predecessor */
+            auto expand_bottom_up = [&](const int /* t */) {
+                while (true) {
+                    size_t begin=cursor.fetch_add(grain);
+                    if (begin>=no_words) {
+                        break;
+                    }
+                    size_t end=std::min(begin+grain,no_words);
+                    for (size_t w=begin; w<end; w++) {
+                        std::uint64_t found=0;
+                        for (abs_type b=0; b<64 && w*64+b<no_states; b++) {
+                            abs_type i=w*64+b;
+                            if ((reach_bits_[w]>>b)&1) {
+                                continue;
+                            }
+                            bool has_pre=false;
+                            for (abs_type j=0; j<no_control_inputs && !has_pre; j++) {
+                                for (abs_type k=0; k<no_dist_inputs && !has_pre; k++) {
+                                    has_pre=any_pre(addr_xuw(i,j,k),[&](const abs_type i2) {
+                                        return is_reachable(i2) && enabled_[addr_xuw(i2,j,k)];
+                                    });
+                                }
+                            }
+                            if (has_pre) {
+                                found|=(std::uint64_t(1)<<b);
+                            }
+                        }
+                        reach_next_bits_[w]=found;
+                    }
+                }
+            };
+            if (bottom_up) {
+                reach_next_bits_.assign(no_words,0);
+            } else {
+                for (int t=0; t<no_threads; t++) {
+                    reach_local_[t].clear();
+                }
+            }
+            size_t level_size=(bottom_up ? no_states-no_visited : reach_frontier_.size());
+            if (no_threads==1 || level_size<min_parallel_frontier_) {
+                if (bottom_up) {
+                    expand_bottom_up(0);
+                } else {
+                    expand_top_down(0);
+                }
+            } else {
+                std::vector<std::thread> threads;
+                for (int t=1; t<no_threads; t++) {
+                    if (bottom_up) {
+                        threads.push_back(std::thread(expand_bottom_up,t));
+                    } else {
+                        threads.push_back(std::thread(expand_top_down,t));
+                    }
+                }
+                if (bottom_up) {
+                    expand_bottom_up(0);
+                } else {
+                    expand_top_down(0);
+                }
+                for (size_t t=0; t<threads.size(); t++) {
+                    threads[t].join();
+                }
+            }
+            /* merge the level into the visited bitset and form the next frontier */
+            reach_next_.clear();
+            if (bottom_up) {
+                for (size_t w=0; w<no_words; w++) {
+                    std::uint64_t found=reach_next_bits_[w];
+                    reach_bits_[w]|=found;
+                    while (found!=0) {
+                        reach_next_.push_back(w*64+__builtin_ctzll(found));
+                        found&=found-1;
+                    }
+                }
+            } else {
+                for (int t=0; t<no_threads; t++) {
+                    for (auto i2=reach_local_[t].begin(); i2!=reach_local_[t].end(); ++i2) {
+                        if (!is_reachable(*i2)) {
+                            reach_bits_[*i2>>6]|=(std::uint64_t(1)<<(*i2&63));
+                            reach_next_.push_back(*i2);
+                        }
+                    }
+                }
+            }
+            no_visited+=reach_next_.size();
+            reach_frontier_.swap(reach_next_);
+            if (mapped_) {
+                /* the next level is expanded in increasing order of the states, so that the mapped transitions are read sequentially, and the pages read so far are dropped */
+                std::sort(reach_frontier_.begin(),reach_frontier_.end());
+                mapped_->release();
+            }
+        }
+        return reach_bits_;
+    }
+    /*! Tells whether a state was found reachable by the last call to compute_reachable_bitset
+     * \param[in] i     state index */
+    inline bool is_reachable(const abs_type i) const {
+        return ((reach_bits_[i>>6]>>(i&63))&1)!=0;
+    }
+    /*! Compute the set of states reachable from the initial states (see compute_reachable_bitset)
+     * \param[out] set  The set of state indices reachable from the initial states*/
+    std::unordered_set<abs_type> compute_reachable_set() {
+        compute_reachable_bitset();
+        std::unordered_set<abs_type> seen;
+        for (abs_type i=0; i<no_states; i++) {
+            if (is_reachable(i)) {
+                seen.insert(i);
             }
         }
-        /* the set seen is the set of reachable states */
         return seen;
     }
     /*! Trim the transitions from the unreachable states (except for the special sink states 0 and 1) */
     void trim_transitions() {
         /* first compute the reachable set of states */
-        std::unordered_set<abs_type> reach_set = compute_reachable_set();
-        /* remove transitions for all the states which are not reachable */
+        compute_reachable_bitset();
+        /* remove transitions for all the states which are not reachable (this leaves the reachable set unchanged, so the bitset stays valid for the caller) */
         for (abs_type i=2; i<no_states; i++) {
             /* if i is in the reachable set, then ignore i */
-            if (reach_set.find(i)!=reach_set.end()) {
+            if (is_reachable(i)) {
                 continue;
             }
             /* iterate over all the control inputs */
             for (abs_type j=0; j<no_control_inputs; j++) {
                 /* iterate over all the disturbance inputs */
                 for (abs_type k=0; k<no_dist_inputs; k++) {
-                    /* iterate over all the posts to update their pre */
-                    for (auto i2=post[addr_xuw(i,j,k)]->begin(); i2!=post[addr_xuw(i,j,k)]->end(); ++i2) {
-                        /* update the pre of i2 */
-                        pre[addr_xuw(*i2,j,k)]->erase(i);
-                    }
-                    /* clear the post entries of state i */
-                    post[addr_xuw(i,j,k)]->clear();
-                    /* reset the number of posts */
-                    no_post[addr_xuw(i,j,k)]=0;
+                    /* remove the transitions of state i */
+                    disable(addr_xuw(i,j,k));
                 }
             }
         }
     }
     /*! Trims the monitor automaton to only the reachable part of the state space.
-     *  The states are re-labeled in this process */
+     *  The states are re-labeled in this process in breadth-first order from the initial states, so that the states connected by a transition get nearby indices. The trimmed transitions are stored in the arena, or in new memory-mapped files when the transitions were stored in memory-mapped files. */
     void trim() {
-        /* first compute the set of reachable states */
-        std::unordered_set<abs_type> reach_set = compute_reachable_set();
         /* mapping from new state indices to old state indices */
         std::vector<abs_type> new_to_old;
-        /* mapping from the old state indices to the new state indices */
-        abs_type* old_to_new = new abs_type[no_states];
+        /* mapping from the old state indices to the new state indices (0 marks the states not yet reached, except for state 0 itself) */
+        std::vector<abs_type> old_to_new(no_states,0);
         /* state 0 and state 1 are always part of the state space no matter whether they're reachable or not; moreover, they are mapped to themselves in the process of relabeling of states */
         new_to_old.push_back(0);
         new_to_old.push_back(1);
         old_to_new[0]=0;
         old_to_new[1]=1;
-        /* allot a state for each of the rest of the reachable states */
-        for (auto i=reach_set.begin(); i!=reach_set.end(); ++i) {
-            if (*i!=0 && *i!=1) {
+        /* allot a state for each of the rest of the reachable states in the order of a breadth-first search over the enabled transitions; new_to_old doubles as the queue of the search */
+        for (auto i=init_.begin(); i!=init_.end(); ++i) {
+            if (*i>=2 && old_to_new[*i]==0) {
                 new_to_old.push_back(*i);
                 old_to_new[*i]=new_to_old.size()-1;
             }
         }
+        /* the memory-mapped transitions are read out of order, so the pages read are dropped from time to time */
+        size_t no_reads=0;
+        auto count_read = [&]() {
+            if (mapped_ && ++no_reads>=mapped_->random_read_period()) {
+                mapped_->release();
+                no_reads=0;
+            }
+        };
+        for (size_t n=0; n<new_to_old.size(); n++) {
+            abs_type i=new_to_old[n];
+            for (abs_type j=0; j<no_control_inputs; j++) {
+                for (abs_type k=0; k<no_dist_inputs; k++) {
+                    abs_ptr_type post_addr=addr_xuw(i,j,k);
+                    if (!enabled_[post_addr]) {
+                        continue;
+                    }
+                    for_each_post(post_addr,[&](const abs_type i2) {
+                        if (i2>=2 && old_to_new[i2]==0) {
+                            new_to_old.push_back(i2);
+                            old_to_new[i2]=new_to_old.size()-1;
+                        }
+                    });
+                    count_read();
+                }
+            }
+        }
         /* update the number of states */
         no_states=new_to_old.size();
         /* update the set of initial states */
@@ -382,50 +721,72 @@ public:
             init_.insert(old_to_new[*i]);
         }
         /* number of control inputs and disturbance inputs remain the same: one benefit of this is that we can use the function addr for computing both the new and old address of post in the post array. */
-        /* compute the new post array */
-        std::unordered_set<abs_type>** post_new = new std::unordered_set<abs_type>*[no_states*no_control_inputs*no_dist_inputs];
-        for (abs_type i_new=0; i_new<no_states; i_new++) {
-            abs_type i_old=new_to_old[i_new];
-            for (abs_type j=0; j<no_control_inputs; j++) {
-                for (abs_type k=0; k<no_dist_inputs; k++) {
-                    abs_type addr_post_old=addr_xuw(i_old,j,k);
-                    abs_type addr_post_new=addr_xuw(i_new,j,k);
-                    std::unordered_set<abs_type>* set = new std::unordered_set<abs_type>;
-                    for (auto i2=post[addr_post_old]->begin(); i2!=post[addr_post_old]->end(); ++i2) {
-                        set->insert(old_to_new[*i2]);
+        /* the posts of the new triple (i_new,j,k) are the relabeled posts of the old triple (i_old,j,k), and the disabled transitions are dropped */
+        auto for_each_new_post = [&](const abs_type i_new, const abs_type j, const abs_type k, const std::function<void(abs_type)>& f) {
+            abs_ptr_type addr_post_old=addr_xuw(new_to_old[i_new],j,k);
+            if (enabled_[addr_post_old]) {
+                for_each_post(addr_post_old,[&](const abs_type i2) {
+                    f(old_to_new[i2]);
+                });
+                count_read();
+            }
+        };
+        if (mapped_) {
+            /* the trimmed transitions are written to new memory-mapped files, triple by triple */
+            std::shared_ptr<MappedTransitions> mapped_new=std::make_shared<MappedTransitions>(mapped_->dir(),size_t(no_states)*no_control_inputs*no_dist_inputs,no_control_inputs*no_dist_inputs,mapped_->memory_budget());
+            std::vector<abs_type> posts;
+            for (abs_type i_new=0; i_new<no_states; i_new++) {
+                for (abs_type j=0; j<no_control_inputs; j++) {
+                    for (abs_type k=0; k<no_dist_inputs; k++) {
+                        posts.clear();
+                        for_each_new_post(i_new,j,k,[&](const abs_type i2) {
+                            posts.push_back(i2);
+                        });
+                        std::sort(posts.begin(),posts.end());
+                        mapped_new->append_post(posts);
                     }
-                    post_new[addr_post_new]=set;
                 }
             }
-        }
-        /* update the post array */
-        delete[] post;
-        post=post_new;
-        /* reallocate a pre array for the new state space size */
-        delete[] pre;
-        pre=new std::unordered_set<abs_type>*[no_states*no_control_inputs*no_dist_inputs];
-        for (abs_type i=0; i<no_states; i++) {
-            for (abs_type j=0; j<no_control_inputs; j++) {
-                for (abs_type k=0; k<no_dist_inputs; k++) {
-                    std::unordered_set<abs_type>* set=new std::unordered_set<abs_type>;
-                    pre[addr_xuw(i,j,k)]=set;
+            mapped_new->finish();
+            mapped_=mapped_new;
+        } else {
+            /* compute the new post array */
+            arena_set** post_new = new_set_array(abs_ptr_type(no_states)*no_control_inputs*no_dist_inputs);
+            for (abs_type i_new=0; i_new<no_states; i_new++) {
+                for (abs_type j=0; j<no_control_inputs; j++) {
+                    for (abs_type k=0; k<no_dist_inputs; k++) {
+                        arena_set* set = new_set();
+                        for_each_new_post(i_new,j,k,[&](const abs_type i2) {
+                            set->insert(i2);
+                        });
+                        post_new[addr_xuw(i_new,j,k)]=set;
+                    }
                 }
             }
-        }
-        /* reset the previous array with the number of predecessors */
-        no_post.clear();
-        /* update the pre array and number of post */
-        for (abs_type i=0; i<no_states; i++) {
-            for (abs_type j=0; j<no_control_inputs; j++) {
-                for (abs_type k=0; k<no_dist_inputs; k++) {
-                    abs_type addr_post=addr_xuw(i,j,k);
-                    for (auto i2=post[addr_post]->begin(); i2!=post[addr_post]->end(); ++i2) {
-                        pre[addr_xuw(*i2,j,k)]->insert(i);
+            /* update the post array (the old one stays in the arena until it is released) */
+            post=post_new;
+            /* reallocate a pre array for the new state space size */
+            pre=new_set_array(abs_ptr_type(no_states)*no_control_inputs*no_dist_inputs);
+            for (abs_type i=0; i<no_states; i++) {
+                for (abs_type j=0; j<no_control_inputs; j++) {
+                    for (abs_type k=0; k<no_dist_inputs; k++) {
+                        pre[addr_xuw(i,j,k)]=new_set();
+                    }
+                }
+            }
+            /* update the pre array */
+            for (abs_type i=0; i<no_states; i++) {
+                for (abs_type j=0; j<no_control_inputs; j++) {
+                    for (abs_type k=0; k<no_dist_inputs; k++) {
+                        abs_ptr_type addr_post=addr_xuw(i,j,k);
+                        for (auto i2=post[addr_post]->begin(); i2!=post[addr_post]->end(); ++i2) {
+                            pre[addr_xuw(*i2,j,k)]->insert(i);
+                        }
                     }
-                    no_post.push_back(post[addr_post]->size());
                 }
             }
         }
+        enabled_.assign(abs_ptr_type(no_states)*no_control_inputs*no_dist_inputs,true);
         /* update the mapping from monitor state indices to the component state indices */
         std::vector<abs_type> monitor_to_component_state_id_old=monitor_to_component_state_id;
         monitor_to_component_state_id.clear();
@@ -439,13 +800,100 @@ public:
         /* mark that the monitor state ids are being changed, so that the functions monitor_state_ind and component_state_ind are disabled */
         monitor_states_were_relabeled=true;
     }
+    /*! Remove the transitions of a state-input triple
+     * \param[in] l     address of the triple (see addr_xuw) */
+    inline void disable(const abs_ptr_type l) {
+        enabled_[l]=false;
+    }
+    /*! Visit the posts of a state-input triple (also when the triple is disabled)
+     * \param[in] l     address of the triple (see addr_xuw)
+     * \param[in] f     called with every post state */
+    template<class F>
+    inline void for_each_post(const abs_ptr_type l, F f) const {
+        if (mapped_) {
+            for (const abs_type* i2=mapped_->post_begin(l); i2!=mapped_->post_end(l); ++i2) {
+                f(*i2);
+            }
+        } else {
+            for (auto i2=post[l]->begin(); i2!=post[l]->end(); ++i2) {
+                f(*i2);
+            }
+        }
+    }
+    /*! Visit the pre states of a state-input triple (the enable bits of the pre triples are not checked)
+     * \param[in] l     address of the triple (see addr_xuw)
+     * \param[in] f     called with every pre state */
+    template<class F>
+    inline void for_each_pre(const abs_ptr_type l, F f) const {
+        if (mapped_) {
+            for (const abs_type* i2=mapped_->pre_begin(l); i2!=mapped_->pre_end(l); ++i2) {
+                f(*i2);
+            }
+        } else {
+            for (auto i2=pre[l]->begin(); i2!=pre[l]->end(); ++i2) {
+                f(*i2);
+            }
+        }
+    }
+    /*! Tells whether some pre state of a state-input triple satisfies a predicate (the search stops at the first one)
+     * \param[in] l     address of the triple (see addr_xuw)
+     * \param[in] p     the predicate */
+    template<class P>
+    inline bool any_pre(const abs_ptr_type l, P p) const {
+        if (mapped_) {
+            for (const abs_type* i2=mapped_->pre_begin(l); i2!=mapped_->pre_end(l); ++i2) {
+                if (p(*i2)) {
+                    return true;
+                }
+            }
+        } else {
+            for (auto i2=pre[l]->begin(); i2!=pre[l]->end(); ++i2) {
+                if (p(*i2)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+    /*! Number of posts of a state-input triple (also when the triple is disabled; see no_post)
+     * \param[in] l     address of the triple (see addr_xuw) */
+    inline abs_type post_size(const abs_ptr_type l) const {
+        if (mapped_) {
+            return mapped_->post_end(l)-mapped_->post_begin(l);
+        }
+        return post[l]->size();
+    }
+    /*! Number of posts of a state-input triple (0 when the triple is disabled)
+     * \param[in] l     address of the triple (see addr_xuw) */
+    inline abs_type no_post(const abs_ptr_type l) const {
+        return (enabled_[l] ? post_size(l) : 0);
+    }
+    /*! Membership querry for the posts of a state-input triple (also when the triple is disabled)
+     * \param[in] l     address of the triple (see addr_xuw)
+     * \param[in] i2    the state */
+    inline bool has_post(const abs_ptr_type l, const abs_type i2) const {
+        if (mapped_) {
+            return std::binary_search(mapped_->post_begin(l),mapped_->post_end(l),i2);
+        }
+        return post[l]->find(i2)!=post[l]->end();
+    }
+    /*! Tells whether the transitions are stored in memory-mapped files */
+    inline bool is_mapped() const {
+        return mapped_!=nullptr;
+    }
+    /*! Drop the pages of the memory-mapped transitions from the resident memory (no-op when the transitions are in the arena); they are read back from the files on the next access */
+    void release_mapped() {
+        if (mapped_) {
+            mapped_->release();
+        }
+    }
     /*! Index of state-control input-disturbance input pair.
      * \param[in] i           state index
      * \param[in] j           control input index
      * \param[in] k           disturbance input index
      * \param[out] ind    address of the post state vector in post **/
-    inline abs_type addr_xuw(const abs_type i, const abs_type j, const abs_type k) {
-        return (i*no_control_inputs*no_dist_inputs + j*no_dist_inputs + k);
+    inline abs_ptr_type addr_xuw(const abs_type i, const abs_type j, const abs_type k) const {
+        return (abs_ptr_type(i)*no_control_inputs*no_dist_inputs + abs_ptr_type(j)*no_dist_inputs + k);
     }
     /*! Joint control action-disturbance input index.
      * \param[in] j           control input index
@@ -458,15 +906,15 @@ public:
      * \param[in] i           state index
      * \param[in] j           input index
      * \param[out] ind    address **/
-    inline int addr_xu(const abs_type i, const abs_type j) {
-        return (i*no_control_inputs + j);
+    inline abs_ptr_type addr_xu(const abs_type i, const abs_type j) const {
+        return (abs_ptr_type(i)*no_control_inputs + j);
     }
     /*! Index of state-control input pair.
      * \param[in] i           state index
      * \param[in] k           disturbance input index
      * \param[out] ind    address **/
-    inline int addr_xw(const abs_type i, const abs_type k) {
-        return (i*no_dist_inputs + k);
+    inline abs_ptr_type addr_xw(const abs_type i, const abs_type k) const {
+        return (abs_ptr_type(i)*no_dist_inputs + k);
     }
     /*! Index of component state from a given monitor state index
      * \param[in] im         component state index
@@ -514,13 +962,44 @@ public:
             return (ic*(na-1)*(ng-1) + (ia-1)*(ng-1) + (ig-1) + 2); /* the -1 with ia and ig are to shift all the ia and ig indeces leftwards, since the reject state is not used in the product. the +2 in the end is to make sure that reject states of the monitor 0,1 are indeed reserved. */
         }
     }
+    /*! Create an empty set in the arena
+     * \param[out] s     pointer to the set */
+    arena_set* new_set() {
+        return arena_->create<arena_set>(ArenaAllocator<abs_type>(arena_.get()));
+    }
+    /*! Create a copy of a set in the arena
+     * \param[in] other  the set to be copied
+     * \param[out] s     pointer to the set */
+    template<class Set>
+    arena_set* new_set(const Set& other) {
+        arena_set* s=new_set();
+        s->insert(other.begin(),other.end());
+        return s;
+    }
+    /*! Create an uninitialized array of set pointers in the arena
+     * \param[in] n      size of the array
+     * \param[out] arr   pointer to the array */
+    arena_set** new_set_array(const size_t n) {
+        return static_cast<arena_set**>(arena_->allocate(n*sizeof(arena_set*),alignof(arena_set*)));
+    }
+    /*! Create a vector of n empty sets in the arena
+     * \param[in] n      size of the vector
+     * \param[out] v     the vector */
+    std::vector<arena_set*> new_set_vector(const size_t n) {
+        std::vector<arena_set*> v;
+        v.reserve(n);
+        for (size_t i=0; i<n; i++) {
+            v.push_back(new_set());
+        }
+        return v;
+    }
     /*! Membership querry for an unordered set.
      *  \param[in] S     The unordered set
      *  \param[in] e    The element
      *  \param[out] out_flag  A boolean flag which is true when e is in S, and is false otherwise*/
-    template<class T>
-    bool isMember(const std::unordered_set<T>& S, const T& e) {
-        typename std::unordered_set<T>::const_iterator it=S.find(e);
+    template<class T, class Set>
+    bool isMember(const Set& S, const T& e) {
+        typename Set::const_iterator it=S.find(e);
         if (it==S.end()) {
             return false;
         } else {
@@ -539,7 +1018,35 @@ public:
         writeMember<abs_type>(filename, "NO_GUARANTEE_STATES", no_guarantee_states);
         writeMember<abs_type>(filename, "NO_CONTROL_INPUTS", no_control_inputs);
         writeMember<abs_type>(filename, "NO_DIST_INPUTS", no_dist_inputs);
-        writeArrSet(filename,"TRANSITION_POST",post, no_states*no_control_inputs*no_dist_inputs);
+        if (mapped_) {
+            /* the posts are written straight from the memory-mapped files, in the format of writeArrSet, and the pages read are dropped from time to time */
+            std::ofstream file(filename, std::ios_base::app);
+            if (!file.is_open()) {
+                try {
+                    throw std::runtime_error("Monitor:writeToFile: Unable to open output file.");
+                } catch (std::exception &e) {
+                    std::cout << e.what() << "\n";
+                }
+                return;
+            }
+            file << "# TRANSITION_POST\n";
+            for (abs_ptr_type l=0; l<abs_ptr_type(no_states)*no_control_inputs*no_dist_inputs; l++) {
+                if (post_size(l)==0) {
+                    file << "x\n";
+                } else {
+                    for_each_post(l,[&](const abs_type i2) {
+                        file << i2 << " ";
+                    });
+                    file << "\n";
+                }
+                if ((l+1)%(1<<20)==0) {
+                    release_mapped();
+                }
+            }
+            release_mapped();
+        } else {
+            writeArrSet(filename,"TRANSITION_POST",post, abs_ptr_type(no_states)*no_control_inputs*no_dist_inputs);
+        }
     }
 };/* end of class defintions*/
 }/* end of namespace negotiation */
@@ -9,11 +9,21 @@
 
 #include <vector>
 #include <unordered_set>
+#include <map>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <functional>
 #include <bits/stdc++.h> /* for setting max_depth_=highest possible integer by default */
 
 #include "Component.hpp" /* for the definition of data types abs_type and abs_ptr_type */
 //#include "FileHandler.hpp"
 #include "LivenessGame.hpp"
+#include "SymbolicSafetyGame.hpp"
+#include "SymbolicLivenessGame.hpp"
+#include "SpoilerCache.hpp"
+#include "ContractCache.hpp"
 
 /** @namespace negotiation **/
 namespace negotiation {
@@ -31,12 +41,49 @@ public:
     std::vector<std::unordered_set<negotiation::abs_type>*> safe_states_;
     /** @brief local liveness specifications of the components **/
     std::vector<std::unordered_set<negotiation::abs_type>*> target_states_;
+    /** @brief for each component, the new index of each state of the component file after the unreachable states were trimmed, or the new number of states for the removed states (see Component::trim) **/
+    std::vector<std::vector<negotiation::abs_type>> trimmed_state_map_;
     /** @brief set of local guarantees for each component (same as the assumption of the other component) **/
     std::vector<negotiation::SafetyAutomaton*> guarantee_;
     /** @brief maximum  search depth **/
     const int max_depth_;
     /** @brief verbosity level between 0 (not verbose) to 2 (debug level verbose) **/
     const int verbose_;
+    /** @brief [used by parallel_iterative_deepening_search] whether the progress messages are suppressed, which is the case for the copies negotiating concurrently **/
+    const bool silent_;
+    /** @brief the stream receiving the progress messages when silent_ is set (it has no buffer, so everything written to it is discarded) **/
+    std::ostream discard_;
+    /** @brief [used by parallel_iterative_deepening_search] the smallest depth whose outcome is already decided; negotiations at larger depths are abandoned **/
+    const std::atomic<int>* decided_depth_;
+    /** @brief memoization of compute_spoilers_overall, shared with the concurrent negotiations spawned from this one (set to nullptr to disable) **/
+    std::shared_ptr<SpoilerCache> spoiler_cache_;
+    /** @brief persistent cache of negotiation outcomes (disabled when set to nullptr, which is the default; see use_contract_cache) **/
+    std::shared_ptr<ContractCache> contract_cache_;
+    /** @brief content hash of all the input files **/
+    std::uint64_t input_hash_;
+    /** @brief the number of threads used inside each safety and reach-avoid game (1 by default; the outcome does not depend on it) **/
+    int solver_threads_;
+    /** @brief [see use_component_quotient] the bisimulation quotients of the components and their safe and target states (empty when the games are solved on the components themselves) **/
+    std::vector<std::shared_ptr<negotiation::Component>> quotient_components_;
+    std::vector<std::shared_ptr<std::unordered_set<negotiation::abs_type>>> quotient_safe_states_;
+    std::vector<std::shared_ptr<std::unordered_set<negotiation::abs_type>>> quotient_target_states_;
+    /** @brief [used by solve_spoilers_overall] the classes of the control inputs and of the disturbance inputs with identical effects on each component, or on its bisimulation quotient when the games are solved on it (see Component::control_input_classes and Component::dist_input_classes) **/
+    std::vector<std::vector<negotiation::abs_type>> control_classes_, dist_classes_;
+    /** @brief [see use_symbolic_engine] whether the games are first solved symbolically, and the smallest size of the monitor (as bounded by the sizes of the component and the specifications) for which they are **/
+    bool symbolic_engine_;
+    double symbolic_min_size_;
+    /** @brief [see use_out_of_core_monitors] the directory of the memory-mapped transitions of the monitors (empty when the monitors are kept in memory), and the memory budget used for building them **/
+    std::string mapped_dir_;
+    size_t mapped_budget_;
+    /** @brief [used by solve_spoilers_overall] the last safety game built for a component index, together with the component, the input representatives, the assumption, and the guarantee it was built for **/
+    struct LastGame {
+        const negotiation::Component* component_;
+        std::vector<negotiation::abs_type> control_reps_, dist_reps_;
+        negotiation::SafetyAutomaton assume_, guarantee_;
+        std::shared_ptr<negotiation::SafetyGame> game_;
+    };
+    /** @brief the last safety games indexed by the component index (not shared with the copies, which negotiate concurrently) **/
+    std::vector<LastGame> last_games_;
 public:
     /*! Constructor
      * \param[in] component_files   A vector containing the names of all the files which contain the encodings of the components
@@ -48,7 +95,7 @@ public:
               const std::vector<std::string*> safe_states_files,
               const std::vector<std::string*> target_states_files,
               const int max_depth=INT_MAX,
-              const int verbose=0) : max_depth_(max_depth), verbose_(verbose) {
+              const int verbose=0) : max_depth_(max_depth), verbose_(verbose), silent_(false), discard_(nullptr), decided_depth_(nullptr), spoiler_cache_(new SpoilerCache), solver_threads_(1), symbolic_engine_(false), symbolic_min_size_(0), mapped_budget_(0) {
         /* sanity check */
         if (component_files.size()!=safe_states_files.size() ||
             component_files.size()!=target_states_files.size() ||
@@ -80,124 +127,145 @@ public:
             readSet(*target_states_files[i], *t, n_target_states, "SET_TARGET_STATES");
             target_states_.push_back(t);
         }
+        /* trim the unreachable parts of the components, and renumber their safe and target states accordingly */
+        for (size_t c=0; c<components_.size(); c++) {
+            trimmed_state_map_.push_back(components_[c]->trim());
+            const std::vector<abs_type>& old_to_new=trimmed_state_map_[c];
+            abs_type no_states=components_[c]->no_states;
+            for (std::unordered_set<abs_type>* s : {safe_states_[c], target_states_[c]}) {
+                std::unordered_set<abs_type> s_old=*s;
+                s->clear();
+                for (auto i=s_old.begin(); i!=s_old.end(); ++i) {
+                    if (*i<old_to_new.size() && old_to_new[*i]<no_states) {
+                        s->insert(old_to_new[*i]);
+                    }
+                }
+            }
+            if (verbose_>0 && old_to_new.size()!=no_states) {
+                std::cout << "Component " << c << ": " << old_to_new.size()-no_states << " unreachable states removed.\n";
+            }
+            /* the components do not change during the negotiation, so their input classes are computed once */
+            control_classes_.push_back(components_[c]->control_input_classes());
+            dist_classes_.push_back(components_[c]->dist_input_classes());
+        }
         /* initialize the sets of guarantees as all accepting safety automata */
         for (int c=0; c<2; c++) {
             negotiation::SafetyAutomaton* s=new negotiation::SafetyAutomaton(components_[c]->no_outputs);
             guarantee_.push_back(s);
         }
-    }
-    /*! Resets the guarantees */
-    void reset(){
-        guarantee_.clear();
-        for (int c=0; c<2; c++) {
-            negotiation::SafetyAutomaton* s=new negotiation::SafetyAutomaton(components_[c]->no_outputs);
-            guarantee_.push_back(s);
+        /* the content hash of the inputs identifies the entries of the contract cache */
+        std::vector<std::string> input_files;
+        for (size_t i=0; i<component_files.size(); i++) {
+            input_files.push_back(*component_files[i]);
+            input_files.push_back(*safe_states_files[i]);
+            input_files.push_back(*target_states_files[i]);
         }
+        input_hash_=ContractCache::hashFiles(input_files);
     }
-    /*! Perform a negotiation by progrssively increasing the length of spoiling behaviors.
-     *  \param[in] starting_component   the index of the component which starts the negotation process (default is 0)
-     *  \param[out] k   the output flag: k=-1 no contract exists, 0<= k <= k_max negotiation successful, k > k_max negotitation was inconclusive (no contract found, but contract might exist for higher value of k_max). */
-    int iterative_deepening_search(int starting_component=0) {
-        /* first clear the existing guarantees if any */
-        reset();
-        /* initialize the length of spoiling behavior set */
-        int k=0;
-        /* for warm-starting the negotiation process by the initially computed spoilers for the starting component */
-        negotiation::SafetyAutomaton* s_init = new negotiation::SafetyAutomaton();
-        std::cout << "\n\nInitiating pre-computation of spoilers for the starting component " << starting_component << "\n";
-        int init_winning = compute_spoilers_overall(starting_component,s_init);
-        /* if the game is losing for the starting component, then change the starting component and try again */
-        if (init_winning==0) {
-            std::cout << "\tThe game is sure losing for component " << starting_component << ".\n";
-            /* flip the starting component and compute the spoiling behavior */
-            starting_component=1-starting_component;
-            std::cout << "Initiating pre-computation of spoilers for the new starting component " << starting_component << "\n";
-            std::cout << "\tComputing spoiler for component " << starting_component << ".\n";
-            init_winning=compute_spoilers_overall(starting_component,s_init);
-            if(init_winning==0) {
-                std::cout << "The game is sure losing for both components. Negotiation is not possible. Terminating.\n";
-                return k;
-            }
+    /*! Copy constructor: the components and the specifications are shared with other, the guarantees are copied
+     * \param[in] other   The negotiation whose attributes are to be copied
+     * \param[in] silent  [Optional] Suppress the progress messages and the debug output (for copies which negotiate concurrently and would otherwise interleave their messages on std::cout and overwrite each other's debug files). Default value=false. */
+    Negotiate(const Negotiate& other, const bool silent=false) : components_(other.components_), safe_states_(other.safe_states_), target_states_(other.target_states_), trimmed_state_map_(other.trimmed_state_map_), max_depth_(other.max_depth_), verbose_(silent ? 0 : other.verbose_), silent_(silent || other.silent_), discard_(nullptr), decided_depth_(other.decided_depth_), spoiler_cache_(other.spoiler_cache_), contract_cache_(other.contract_cache_), input_hash_(other.input_hash_), solver_threads_(other.solver_threads_), quotient_components_(other.quotient_components_), quotient_safe_states_(other.quotient_safe_states_), quotient_target_states_(other.quotient_target_states_), control_classes_(other.control_classes_), dist_classes_(other.dist_classes_), symbolic_engine_(other.symbolic_engine_), symbolic_min_size_(other.symbolic_min_size_), mapped_dir_(other.mapped_dir_), mapped_budget_(other.mapped_budget_) {
+        for (size_t c=0; c<other.guarantee_.size(); c++) {
+            guarantee_.push_back(new negotiation::SafetyAutomaton(*other.guarantee_[c]));
         }
-        /* save debug info */
-        if (verbose_>1) {
-            s_init->writeToFile("Outputs/spoiler.txt");
+    }
+    Negotiate& operator=(const Negotiate&)=delete;
+    /*! Destructor */
+    ~Negotiate() {
+        for (size_t c=0; c<guarantee_.size(); c++) {
+            delete guarantee_[c];
         }
-        /* variable for checking saturation of the k-minimization */
-        bool saturated=false;
-        /* negotiate until either a solution is found, or until k reaches maximum depth */
-        while (1) {
-            /* stop when maximum depth is reached */
-            if (k>max_depth_) {
-                std::cout << "Maximum search depth of spoiling behavior reached. Existence of solution unknown. Terminating." << '\n';
-                return k;
+    }
+    /*! Store the outcomes of the negotiations persistently in a cache directory, and reuse them whenever the same negotiation (with identical input files and search parameters) is repeated.
+     * \param[in] dir   the cache directory, which may be shared by several processes */
+    void use_contract_cache(const std::string& dir) {
+        contract_cache_.reset(new ContractCache(dir));
+    }
+    /*! First solve the games on symbolic monitors (see SymbolicMonitor), whose transitions are BDDs over the bits of the component states, the specification states, and the inputs. The symbolic games decide the rounds in which all the initial states are sure winning or some initial state is losing, without building the explicit monitor; the explicit games are only solved for the rounds in between, as the spoilers are extracted from the explicit monitor. The outcome of the negotiation is the same.
+     *
+     * A round which the symbolic games do not decide costs both the symbolic and the explicit games, and on small monitors the explicit games are cheaper than setting up the symbolic ones even when the latter decide the round. The symbolic games are therefore only tried when the monitor can be large: when the product of the numbers of component states, assumption states, guarantee states, control inputs and disturbance inputs is at least min_size.
+     * \param[in] enable    [Optional] whether the symbolic engine is used (default: true)
+     * \param[in] min_size  [Optional] the smallest monitor size bound for which the symbolic games are tried (default: 2^14; 0 tries them in every round) */
+    void use_symbolic_engine(const bool enable=true, const double min_size=double(1<<14)) {
+        symbolic_engine_=enable;
+        symbolic_min_size_=min_size;
+    }
+    /*! Store the transitions of the monitors in memory-mapped temporary files instead of the memory (see MappedTransitions), for the products which do not fit into the memory. The monitors are then always built from scratch, as the incremental update of the last monitor of a component keeps the transitions in memory. The outcome of the negotiation is the same.
+     * \param[in] dir               the directory of the temporary files (an empty string keeps the monitors in memory)
+     * \param[in] memory_budget     [Optional] the resident memory used by the transitions of a monitor (the enable bits and the pages of the files) while it is built, in bytes (default: 256 MiB) */
+    void use_out_of_core_monitors(const std::string& dir, const size_t memory_budget=size_t(256)<<20) {
+        mapped_dir_=dir;
+        mapped_budget_=memory_budget;
+    }
+    /*! Solve the games on the bisimulation quotients of the components instead of the components themselves. Two states of a component are equivalent if they have the same output, they agree on being safe and on being a target, and they have equivalent post states for every control and disturbance input. The outcome of the negotiation is the same, as the spoilers do not refer to the component states. */
+    void use_component_quotient() {
+        quotient_components_.clear();
+        quotient_safe_states_.clear();
+        quotient_target_states_.clear();
+        for (size_t c=0; c<components_.size(); c++) {
+            negotiation::Component& comp=*components_[c];
+            /* the initial partition is given by the output and the membership in the safe and the target states */
+            std::vector<std::vector<abs_type>> keys(comp.no_states);
+            for (abs_type i=0; i<comp.no_states; i++) {
+                keys[i].push_back(comp.state_to_output[i]);
+                keys[i].push_back(safe_states_[c]->find(i)!=safe_states_[c]->end());
+                keys[i].push_back(target_states_[c]->find(i)!=target_states_[c]->end());
             }
-            /* stop when the k-minimization gets saturated */
-            if (saturated) {
-                std::cout << "Search got saturated in the depth of spoiling behavior. No solution exists. Terminating." << '\n';
-                return -1;
-            } else {
-                saturated=true;
+            std::vector<abs_type> state_class=comp.bisimulation_classes(classes_of_equal_keys(keys));
+            quotient_components_.push_back(std::make_shared<negotiation::Component>(comp,state_class));
+            std::shared_ptr<std::unordered_set<abs_type>> safe=std::make_shared<std::unordered_set<abs_type>>();
+            for (auto i=safe_states_[c]->begin(); i!=safe_states_[c]->end(); ++i) {
+                safe->insert(state_class[*i]);
             }
-            /* recursively perform the negotiation */
-            std::cout << "current depth = " << k << std::endl;
-            /* flag for checking success */
-            bool success;
-            if (init_winning==2) {
-                /* the initial component is sure winning, so start with the other component, and noting that one of the components is winning */
-                std::cout << "\tThe game is sure winning for component " << starting_component << "." << '\n';
-                success = recursive_negotiation(k,1-starting_component,1,saturated);
-            } else {
-                /* find the spoilers for the starting_component upto the current depth, and update the current set of assumptions and guarantees */
-                std::cout << "\tCompressing spoilers for component " << starting_component << "." << '\n';
-                /* object for minimizing the spoiling behaviors */
-                negotiation::Spoilers spoiler(s_init);
-                /* minimize spoilers */
-                spoiler.boundedBisim(k);
-                /* check saturation */
-                if (spoiler.k_==k && saturated) {
-                    saturated=false;
-                }
-                /* determinize the minimized spoiler automaton */
-                spoiler.spoilers_mini_->determinize();
-                /* minimize the guarantee automaton further before saving */
-                negotiation::Spoilers guarantee_final(spoiler.spoilers_mini_);
-                guarantee_final.boundedBisim();
-                /* update the guarantee required from the other component */
-                *guarantee_[1-starting_component]=*guarantee_final.spoilers_mini_;
-                /* save debug info */
-                if (verbose_>1) {
-                    guarantee_[0]->writeToFile("Outputs/guarantee_0.txt");
-                    guarantee_[1]->writeToFile("Outputs/guarantee_1.txt");
-                }
-                success = recursive_negotiation(k,1-starting_component,0,saturated);
+            quotient_safe_states_.push_back(safe);
+            std::shared_ptr<std::unordered_set<abs_type>> target=std::make_shared<std::unordered_set<abs_type>>();
+            for (auto i=target_states_[c]->begin(); i!=target_states_[c]->end(); ++i) {
+                target->insert(state_class[*i]);
             }
-            if (success) {
-                return k;
-            } else {
-                /* reset the sets of guarantees */
-                guarantee_.clear();
-                /* re-initialize the sets of guarantees as all accepting safety automata */
-                for (int c=0; c<2; c++) {
-                    negotiation::SafetyAutomaton* s=new negotiation::SafetyAutomaton(components_[c]->no_outputs);
-                    guarantee_.push_back(s);
-                }
-                /* increment k and continue the search */
-                k++;
+            quotient_target_states_.push_back(target);
+            if (verbose_>0) {
+                std::cout << "Component " << c << ": " << comp.no_states << " states, " << quotient_components_[c]->no_states << " bisimulation classes.\n";
             }
+            control_classes_[c]=quotient_components_[c]->control_input_classes();
+            dist_classes_[c]=quotient_components_[c]->dist_input_classes();
         }
     }
+    /*! Resets the guarantees, and releases the games kept for updating them in the next rounds */
+    void reset(){
+        reset_guarantees();
+        last_games_.clear();
+    }
+    /*! Perform a negotiation by progrssively increasing the length of spoiling behaviors.
+     *  \param[in] starting_component   the index of the component which starts the negotation process (default is 0)
+     *  \param[out] k   the output flag: k=-1 no contract exists, 0<= k <= k_max negotiation successful, k > k_max negotitation was inconclusive (no contract found, but contract might exist for higher value of k_max). */
+    int iterative_deepening_search(int starting_component=0) {
+        std::vector<int> params={0,max_depth_,starting_component};
+        return cached_search(params, [&]() { return search_iteratively(starting_component); });
+    }
+    /*! Same as iterative_deepening_search, but several lengths of spoiling behaviors are tried concurrently.
+     *
+     *  Each depth is negotiated by a separate worker on its own copy of the guarantees. The depths are handed out in increasing order, and as soon as the outcome of some depth is decided (either the negotiation succeeded, or it failed with saturation), the workers on the larger depths are cancelled. The result is the same as the one of iterative_deepening_search: the smallest successful depth wins.
+     *  \param[in] starting_component   the index of the component which starts the negotation process (default is 0)
+     *  \param[in] no_threads               [Optional] number of depths which are explored at the same time. Default value=number of hardware threads.
+     *  \param[out] k   the output flag: k=-1 no contract exists, 0<= k <= k_max negotiation successful, k > k_max negotitation was inconclusive (no contract found, but contract might exist for higher value of k_max). */
+    int parallel_iterative_deepening_search(int starting_component=0, unsigned no_threads=0) {
+        std::vector<int> params={0,max_depth_,starting_component};
+        return cached_search(params, [&]() { return search_iteratively_in_parallel(starting_component,no_threads); });
+    }
     /*! Perform a negotiation by progrssively increasing the length of spoiling behaviors.
      *  \param[in] k   the depth reached. When k>max_depth_, then this indicates that the negotiation has failed.
      *  \param[in] starting_component   the index of the component which starts the negotation process (default is 0)
      *  \param[out] output_flag     0- no contract exists, 1- negotiation inconclusive (contract might exist for higher value of k), 2- negotiation successful. */
     int fixed_depth_search(int k, int starting_component=0) {
-        /* first clear the existing guarantees if any */
-        reset();
-        /* output flag */
-        int output_flag;
-        /* for warm-starting the negotiation process by the initially computed spoilers for the starting component */
-        negotiation::SafetyAutomaton* s_init = new negotiation::SafetyAutomaton();
+        std::vector<int> params={1,k,starting_component};
+        return cached_search(params, [&]() { return search_at_fixed_depth(k,starting_component); });
+    }
+    /*! Pre-compute the spoilers for the starting component, which are used for warm-starting the negotiation at every depth.
+     * \param[in] starting_component    the index of the component which starts the negotiation process; flipped if the game is sure losing for this component
+     * \param[in] s_init                            the safety automaton storing the spoiling behaviors of the starting component
+     * \param[out] init_winning         0 -> the game is sure losing for both components, 2 -> the game is sure winning for the starting component, 1-> otherwise. */
+    int compute_initial_spoilers(int& starting_component, negotiation::SafetyAutomaton* s_init) {
         std::cout << "\n\nInitiating pre-computation of spoilers for the starting component " << starting_component << "\n";
         int init_winning = compute_spoilers_overall(starting_component,s_init);
         /* if the game is losing for the starting component, then change the starting component and try again */
@@ -210,54 +278,50 @@ public:
             init_winning=compute_spoilers_overall(starting_component,s_init);
             if(init_winning==0) {
                 std::cout << "The game is sure losing for both components. Negotiation is not possible. Terminating.\n";
-                return k;
+                return init_winning;
             }
         }
         /* save debug info */
         if (verbose_>1) {
             s_init->writeToFile("Outputs/spoiler.txt");
         }
-        /* variable for checking saturation of the k-minimization */
-        bool saturated=false;
-        /* flag for checking success */
-        bool success;
+        return init_winning;
+    }
+    /*! Perform the negotiation for one fixed length of spoiling behaviors, starting from the pre-computed spoilers of the starting component.
+     * \param[in] k                                 prescribed length of the spoiling behavior set
+     * \param[in] starting_component    the index of the component which starts the negotiation process
+     * \param[in] init_winning              the output of compute_initial_spoilers
+     * \param[in] s_init                            the pre-computed spoilers of the starting component
+     * \param[in] saturated                     a boolean flag checking whether the negotiation process got saturated in the depth of the spoiler minimization
+     * \param[out] true/false               success/failure of the negotiation. */
+    bool negotiate_at_depth(const int k, const int starting_component, const int init_winning, negotiation::SafetyAutomaton* s_init, bool& saturated) {
+        /* recursively perform the negotiation */
+        log() << "current depth = " << k << std::endl;
         if (init_winning==2) {
             /* the initial component is sure winning, so start with the other component, and noting that one of the components is winning */
-            std::cout << "\tThe game is sure winning for component " << starting_component << "." << '\n';
-            success = recursive_negotiation(k,1-starting_component,1,saturated);
-        } else {
-            /* find the spoilers for the starting_component upto the current depth, and update the current set of assumptions and guarantees */
-            std::cout << "\tCompressing spoilers for component " << starting_component << "." << '\n';
-            /* object for minimizing the spoiling behaviors */
-            negotiation::Spoilers spoiler(s_init);
-            /* minimize spoilers */
-            spoiler.boundedBisim(k);
-            /* check saturation */
-            if (spoiler.k_==k && saturated) {
-                saturated=false;
-            }
-            /* determinize the minimized spoiler automaton */
-            spoiler.spoilers_mini_->determinize();
-            /* minimize the guarantee automaton further before saving */
-            negotiation::Spoilers guarantee_final(spoiler.spoilers_mini_);
-            guarantee_final.boundedBisim();
-            /* update the guarantee required from the other component */
-            *guarantee_[1-starting_component]=*guarantee_final.spoilers_mini_;
-            /* save debug info */
-            if (verbose_>1) {
-                guarantee_[0]->writeToFile("Outputs/guarantee_0.txt");
-                guarantee_[1]->writeToFile("Outputs/guarantee_1.txt");
-            }
-            success = recursive_negotiation(k,1-starting_component,0,saturated);
+            log() << "\tThe game is sure winning for component " << starting_component << "." << '\n';
+            return recursive_negotiation(k,1-starting_component,1,saturated);
         }
-        if (success) {
-            output_flag=2;
-        } else if (saturated) {
-            output_flag=0;
-        } else {
-            output_flag=1;
+        /* find the spoilers for the starting_component upto the current depth, and update the current set of assumptions and guarantees */
+        log() << "\tCompressing spoilers for component " << starting_component << "." << '\n';
+        /* object for minimizing the spoiling behaviors */
+        negotiation::Spoilers spoiler(s_init);
+        /* minimize spoilers */
+        spoiler.boundedBisim(k);
+        /* check saturation */
+        if (spoiler.k_==k && saturated) {
+            saturated=false;
         }
-        return output_flag;
+        /* shrink the spoiler automaton before the subset construction */
+        spoiler.spoilers_mini_->reduceBySimulation();
+        /* update the guarantee required from the other component: determinize and minimize the minimized spoiler automaton (its product with the universal automaton is the automaton itself) */
+        *guarantee_[1-starting_component]=negotiation::SafetyAutomaton(spoiler.spoilers_mini_->no_inputs_).determinizedProduct(*spoiler.spoilers_mini_);
+        /* save debug info */
+        if (verbose_>1) {
+            guarantee_[0]->writeToFile("Outputs/guarantee_0.txt");
+            guarantee_[1]->writeToFile("Outputs/guarantee_1.txt");
+        }
+        return recursive_negotiation(k,1-starting_component,0,saturated);
     }
     /*! Perform negotiation recursively with fixed length of spoiling behavior.
      * \param[in] k         prescribed length of the spoiling behavior set.
@@ -266,44 +330,43 @@ public:
      * \param[in] is_saturated  a boolean flag checking whether the negotiation process got saturated in the depth of the spoiler minimization
      * \param[out] true/false   success/failure of the negotiation. */
     bool recursive_negotiation(const int k, const int c, int done, bool& is_saturated) {
-        std::cout << "\tTurn = " << c << '\n';
-        negotiation::SafetyAutomaton* s = new negotiation::SafetyAutomaton();
-        std::cout << "\tComputing spoiler for component " << c << ".\n";
-        int flag = compute_spoilers_overall(c,s);
+        /* abandon the negotiation when a smaller depth has already decided the outcome */
+        if (decided_depth_!=nullptr && decided_depth_->load()<k) {
+            return false;
+        }
+        log() << "\tTurn = " << c << '\n';
+        negotiation::SafetyAutomaton s;
+        log() << "\tComputing spoiler for component " << c << ".\n";
+        int flag = compute_spoilers_overall(c,&s);
         /* save debug info */
         if (verbose_>1) {
-            s->writeToFile("Outputs/spoiler.txt");
+            s.writeToFile("Outputs/spoiler.txt");
         }
         if (flag==0) {
             /* when the game is sure losing for component c, the negotiation fails */
-            std::cout << "\tThe game is sure losing for component " << c << "." << '\n';
+            log() << "\tThe game is sure losing for component " << c << "." << '\n';
             return false;
         } else if (done==1 && flag==2) {
             /* when both the components have sure winning strategies with the current set of contracts, the negotiation successfully terminates */
-            std::cout << "\tThe game is sure winning for both of the components. The negoitaiotn succeeded. Terminating the process." << '\n';
+            log() << "\tThe game is sure winning for both of the components. The negoitaiotn succeeded. Terminating the process." << '\n';
             return true;
         } else if (done==0 && flag==2) {
             /* when the component c---but not (1-c)---has a sure winning strategy with the present contract, it's component (1-c)'s turn to compute the spoilers */
-            std::cout << "\tThe game is sure winning for component " << c << "." << '\n';
+            log() << "\tThe game is sure winning for component " << c << "." << '\n';
             return recursive_negotiation(k,1-c,done+1,is_saturated);
         } else {
             /* compress the spoilers for component c, and update the current set of assumptions and guarantees */
-            std::cout << "\tCompressing spoilers for component " << c << "." << '\n';
-            negotiation::Spoilers spoiler(s);
+            log() << "\tCompressing spoilers for component " << c << "." << '\n';
+            negotiation::Spoilers spoiler(std::move(s));
             spoiler.boundedBisim(k);
             /* check saturation */
             if (spoiler.k_==k && is_saturated) {
                 is_saturated=false;
             }
-            /* update the guarantee of the other component */
-            negotiation::SafetyAutomaton guarantee_updated(*guarantee_[1-c],*spoiler.spoilers_mini_);
-            guarantee_updated.trim();
-            /* determinize the guarantee (trimming might cause non-determinism) */
-            guarantee_updated.determinize();
-            /* minimize the guarantee automaton before saving */
-            negotiation::Spoilers guarantee_final(&guarantee_updated);
-            guarantee_final.boundedBisim();
-            *guarantee_[1-c]=*guarantee_final.spoilers_mini_;
+            /* shrink the spoiler automaton before the subset construction */
+            spoiler.spoilers_mini_->reduceBySimulation();
+            /* update the guarantee of the other component: the reachable part of its product with the spoilers, determinized and minimized in one pass */
+            *guarantee_[1-c]=guarantee_[1-c]->determinizedProduct(*spoiler.spoilers_mini_);
             /* save the current pair of guarantees */
             if (verbose_>1) {
                 guarantee_[0]->writeToFile("Outputs/guarantee_0.txt");
@@ -318,16 +381,290 @@ public:
         }
     }
     /*! Find the overall spoiling behavior for a given component in the form of a safety automaton.
+     *
+     * The result is looked up in (and afterwards stored to) spoiler_cache_, if it is set.
      * \param[in] c             the component index
      * \param[in] spoilers      the pointer to the safety automaton storing the spoiling behaviors
      * \param[out] out_flag   0 -> some initial states are sure losing, 2 -> all initial states are sure winning, 1-> otherwise. */
     int compute_spoilers_overall(const int c, negotiation::SafetyAutomaton* spoilers) {
+        negotiation::SafetyAutomaton& guarantee=*guarantee_[c];
+        negotiation::SafetyAutomaton& assume=*guarantee_[1-c];
+        int out_flag;
+        if (spoiler_cache_ && spoiler_cache_->lookup(c,guarantee,assume,spoilers,out_flag)) {
+            if (verbose_>1) {
+                std::cout << "\t\tSpoilers found in the cache.\n";
+            }
+            return out_flag;
+        }
+        out_flag=solve_spoilers_overall(c,guarantee,assume,spoilers);
+        if (spoiler_cache_) {
+            spoiler_cache_->insert(c,guarantee,assume,*spoilers,out_flag);
+        }
+        return out_flag;
+    }
+private:
+    /*! Resets the guarantees to the all accepting safety automata, keeping the games of the last rounds (see reset) */
+    void reset_guarantees() {
+        for (size_t c=0; c<guarantee_.size(); c++) {
+            delete guarantee_[c];
+        }
+        guarantee_.clear();
+        for (int c=0; c<2; c++) {
+            negotiation::SafetyAutomaton* s=new negotiation::SafetyAutomaton(components_[c]->no_outputs);
+            guarantee_.push_back(s);
+        }
+    }
+    /*! The stream of the progress messages: std::cout, or a stream discarding everything if silent_ is set */
+    std::ostream& log() {
+        return (silent_ ? discard_ : std::cout);
+    }
+    /*! Run a search, unless its outcome is already stored in contract_cache_ (if set); the outcome of the search is stored in contract_cache_ afterwards.
+     * \param[in] params    the parameters identifying the search (kind of search, depth, starting component)
+     * \param[in] search    the search
+     * \param[out] outcome  the output of the search */
+    int cached_search(const std::vector<int>& params, const std::function<int()>& search) {
+        int outcome;
+        if (contract_cache_ && contract_cache_->lookup(input_hash_,params,outcome,guarantee_)) {
+            std::cout << "The negotiation outcome was found in the cache " << contract_cache_->dir_ << ".\n";
+            return outcome;
+        }
+        outcome=search();
+        /* the games kept for the next rounds (and their arenas) are not needed after the search */
+        last_games_.clear();
+        if (contract_cache_) {
+            contract_cache_->store(input_hash_,params,outcome,guarantee_);
+        }
+        return outcome;
+    }
+    /*! The body of iterative_deepening_search */
+    int search_iteratively(int starting_component) {
+        /* first clear the existing guarantees if any */
+        reset();
+        /* initialize the length of spoiling behavior set */
+        int k=0;
+        /* for warm-starting the negotiation process by the initially computed spoilers for the starting component */
+        negotiation::SafetyAutomaton s_init;
+        int init_winning = compute_initial_spoilers(starting_component,&s_init);
+        if (init_winning==0) {
+            return k;
+        }
+        /* variable for checking saturation of the k-minimization */
+        bool saturated=false;
+        /* negotiate until either a solution is found, or until k reaches maximum depth */
+        while (1) {
+            /* stop when maximum depth is reached */
+            if (k>max_depth_) {
+                std::cout << "Maximum search depth of spoiling behavior reached. Existence of solution unknown. Terminating." << '\n';
+                return k;
+            }
+            /* stop when the k-minimization gets saturated */
+            if (saturated) {
+                std::cout << "Search got saturated in the depth of spoiling behavior. No solution exists. Terminating." << '\n';
+                return -1;
+            } else {
+                saturated=true;
+            }
+            /* flag for checking success */
+            bool success = negotiate_at_depth(k,starting_component,init_winning,&s_init,saturated);
+            if (success) {
+                return k;
+            } else {
+                /* re-initialize the sets of guarantees as all accepting safety automata; the games of the last rounds are kept, as the next depth starts from the same guarantees */
+                reset_guarantees();
+                /* increment k and continue the search */
+                k++;
+            }
+        }
+    }
+    /*! The body of parallel_iterative_deepening_search */
+    int search_iteratively_in_parallel(int starting_component, unsigned no_threads) {
+        /* first clear the existing guarantees if any */
+        reset();
+        /* the spoilers for the starting component are shared by all the depths */
+        negotiation::SafetyAutomaton s_init;
+        int init_winning = compute_initial_spoilers(starting_component,&s_init);
+        if (init_winning==0) {
+            return 0;
+        }
+        if (no_threads==0) {
+            no_threads=std::max(1u,std::thread::hardware_concurrency());
+        }
+        /* the next depth to be handed out to a worker */
+        std::atomic<int> next_depth(0);
+        /* the smallest depth whose outcome is decided: the workers on larger depths are cancelled */
+        std::atomic<int> decided_depth(INT_MAX);
+        /* the outcome (success, saturated) of every finished depth, and the guarantees of every successful depth */
+        std::mutex results_mutex;
+        std::map<int,std::pair<bool,bool>> results;
+        std::map<int,std::vector<negotiation::SafetyAutomaton*>> successful_guarantees;
+        auto worker = [&]() {
+            while (1) {
+                int k=next_depth++;
+                if (k>max_depth_ || k>decided_depth.load()) {
+                    return;
+                }
+                /* each depth gets its own negotiation state; the components and the specifications are only read */
+                negotiation::Negotiate local(*this,true);
+                local.reset();
+                local.decided_depth_=&decided_depth;
+                negotiation::SafetyAutomaton s_local(s_init);
+                bool saturated=true;
+                bool success = local.negotiate_at_depth(k,starting_component,init_winning,&s_local,saturated);
+                /* cancelled: the outcome of this depth is not needed */
+                if (k>decided_depth.load()) {
+                    return;
+                }
+                std::lock_guard<std::mutex> lock(results_mutex);
+                results[k]=std::make_pair(success,saturated);
+                if (success) {
+                    successful_guarantees[k].swap(local.guarantee_);
+                }
+                /* the outcome of the whole search is decided at this depth */
+                if (success || saturated) {
+                    int d=decided_depth.load();
+                    while (k<d && !decided_depth.compare_exchange_weak(d,k)) {}
+                }
+            }
+        };
+        std::vector<std::thread> workers;
+        for (unsigned t=0; t<no_threads; t++) {
+            workers.push_back(std::thread(worker));
+        }
+        for (size_t t=0; t<workers.size(); t++) {
+            workers[t].join();
+        }
+        /* go through the depths in increasing order, exactly as iterative_deepening_search would have done */
+        int outcome;
+        for (int k=0; ; k++) {
+            if (k>max_depth_) {
+                std::cout << "Maximum search depth of spoiling behavior reached. Existence of solution unknown. Terminating." << '\n';
+                outcome=k;
+                break;
+            }
+            bool success=results[k].first;
+            bool saturated=results[k].second;
+            if (success) {
+                guarantee_.swap(successful_guarantees[k]);
+                outcome=k;
+                break;
+            } else if (saturated && k+1<=max_depth_) {
+                std::cout << "Search got saturated in the depth of spoiling behavior. No solution exists. Terminating." << '\n';
+                outcome=-1;
+                break;
+            }
+        }
+        /* free the guarantees which were not adopted */
+        for (auto it=successful_guarantees.begin(); it!=successful_guarantees.end(); ++it) {
+            for (size_t c=0; c<it->second.size(); c++) {
+                delete it->second[c];
+            }
+        }
+        return outcome;
+    }
+    /*! The body of fixed_depth_search */
+    int search_at_fixed_depth(int k, int starting_component) {
+        /* first clear the existing guarantees if any */
+        reset();
+        /* output flag */
+        int output_flag;
+        /* for warm-starting the negotiation process by the initially computed spoilers for the starting component */
+        negotiation::SafetyAutomaton s_init;
+        int init_winning = compute_initial_spoilers(starting_component,&s_init);
+        if (init_winning==0) {
+            return k;
+        }
+        /* variable for checking saturation of the k-minimization */
+        bool saturated=false;
+        /* flag for checking success */
+        bool success = negotiate_at_depth(k,starting_component,init_winning,&s_init,saturated);
+        if (success) {
+            output_flag=2;
+        } else if (saturated) {
+            output_flag=0;
+        } else {
+            output_flag=1;
+        }
+        return output_flag;
+    }
+    /*! Find the overall spoiling behavior for a given component by solving the safety and the liveness games (see compute_spoilers_overall).
+     * \param[in] c             the component index
+     * \param[in] guarantee     the guarantee of component c
+     * \param[in] assume        the assumption of component c
+     * \param[in] spoilers      the pointer to the safety automaton storing the spoiling behaviors
+     * \param[out] out_flag   0 -> some initial states are sure losing, 2 -> all initial states are sure winning, 1-> otherwise. */
+    int solve_spoilers_overall(const int c, negotiation::SafetyAutomaton& guarantee, negotiation::SafetyAutomaton& assume, negotiation::SafetyAutomaton* spoilers) {
         /* the output flag */
         int out_flag;
-        /* find the spoilers for the safety part */
-        negotiation::SafetyGame monitor(*components_[c],*guarantee_[1-c],*guarantee_[c]);
-        std::vector<std::unordered_set<abs_type>*> sure_safe = monitor.solve_safety_game(*safe_states_[c],"sure");
-        std::vector<std::unordered_set<abs_type>*> maybe_safe = monitor.solve_safety_game(*safe_states_[c],"maybe");
+        /* the component and its specifications, or their bisimulation quotients (see use_component_quotient) */
+        negotiation::Component& component=(quotient_components_.empty() ? *components_[c] : *quotient_components_[c]);
+        std::unordered_set<abs_type>& safe_states=(quotient_components_.empty() ? *safe_states_[c] : *quotient_safe_states_[c]);
+        std::unordered_set<abs_type>& target_states=(quotient_components_.empty() ? *target_states_[c] : *quotient_target_states_[c]);
+        /* the games are solved over one representative of every class of inputs with identical effects: the control inputs are compared on the component, and the disturbance inputs on both the component and the assumption (the guarantee of the other component); only the latter changes between the rounds */
+        std::vector<abs_type> dist_class=dist_classes_[c];
+        assume.refineInputClasses(dist_class);
+        std::vector<abs_type> control_reps=class_representatives(control_classes_[c]);
+        std::vector<abs_type> dist_reps=class_representatives(dist_class);
+        negotiation::Component comp(component,control_reps,dist_reps);
+        negotiation::SafetyAutomaton assume_reps=assume.restrictInputs(dist_reps);
+        if (verbose_>1) {
+            std::cout << "\t\tNumber of control input classes = " << comp.no_control_inputs << ", number of disturbance input classes = " << comp.no_dist_inputs << ".\n";
+        }
+        /* the rounds which are won or lost from all the initial states are decided by the symbolic games (see use_symbolic_engine); the reject states of the specifications are not part of the product */
+        if (symbolic_engine_ && double(comp.no_states)*(assume_reps.no_states_-1)*(guarantee.no_states_-1)*comp.no_control_inputs*comp.no_dist_inputs>=symbolic_min_size_) {
+            int symbolic_flag=decide_symbolically(comp,assume_reps,guarantee,safe_states,target_states);
+            if (verbose_>1 && symbolic_flag!=1) {
+                std::cout << "\t\tDecided by the symbolic games.\n";
+            }
+            if (symbolic_flag==0) {
+                out_flag=0;
+                return out_flag;
+            } else if (symbolic_flag==2) {
+                /* the spoiling behavior is empty (see SafetyGame::find_spoilers and LivenessGame::find_spoilers) */
+                negotiation::Spoilers overall(SafetyAutomaton(comp.no_dist_inputs));
+                overall.boundedBisim();
+                *spoilers=std::move(*overall.spoilers_mini_);
+                spoilers->expandInputs(dist_class);
+                out_flag=2;
+                return out_flag;
+            }
+        }
+        /* all the monitors and the strategies of this round are allocated from one arena; it is released when the next round of the same component index replaces last_games_[c] (so the arenas of two rounds are alive at a time), or at the latest by reset() and at the end of the search */
+        std::shared_ptr<Arena> arena=std::make_shared<Arena>();
+        /* find the spoilers for the safety part: between two rounds usually only a part of the assumption and of the guarantee changes, so the game is updated from the last one built for this component index whenever it was built over the same inputs */
+        if (last_games_.size()<=static_cast<size_t>(c)) {
+            last_games_.resize(c+1);
+        }
+        LastGame& last=last_games_[c];
+        std::shared_ptr<negotiation::SafetyGame> game;
+        if (!mapped_dir_.empty()) {
+            /* the memory-mapped games are not updated, so the last one (and its arena) is released before the new one is built */
+            last.game_.reset();
+            game=std::make_shared<negotiation::SafetyGame>(comp,assume_reps,guarantee,mapped_dir_,mapped_budget_,arena);
+        } else if (last.game_ && last.component_==&component && last.control_reps_==control_reps && last.dist_reps_==dist_reps) {
+            game=std::make_shared<negotiation::SafetyGame>(*last.game_,last.assume_,last.guarantee_,comp,assume_reps,guarantee,arena);
+        } else {
+            game=std::make_shared<negotiation::SafetyGame>(comp,assume_reps,guarantee,arena);
+        }
+        last.component_=&component;
+        last.control_reps_=control_reps;
+        last.dist_reps_=dist_reps;
+        last.assume_=assume_reps;
+        last.guarantee_=guarantee;
+        if (mapped_dir_.empty()) {
+            last.game_=game;
+        }
+        negotiation::SafetyGame& monitor=*game;
+        monitor.no_threads_=solver_threads_;
+        /* the games are solved locally, i.e. only on the part of the monitor reachable from the initial states */
+        std::vector<arena_set*> sure_safe = monitor.solve_safety_game(safe_states,"sure",true);
+        /* the maybe winning strategy is not needed when all the initial states are sure winning; otherwise its computation stops as soon as some initial state is found to be maybe losing, as the game is then lost */
+        bool all_init_sure_safe=true;
+        for (auto i=monitor.init_.begin(); i!=monitor.init_.end(); ++i) {
+            if (sure_safe[*i]->size()==0) {
+                all_init_sure_safe=false;
+            }
+        }
+        std::vector<arena_set*> maybe_safe = (all_init_sure_safe ? monitor.new_set_vector(monitor.no_states) : monitor.solve_safety_game(safe_states,"maybe",true));
         /* debugging: print the number of sure and maybe winning states */
         if (verbose_>1) {
             int num_maybe=0;
@@ -341,10 +678,15 @@ public:
                 }
             }
             std::cout << "\t\tNumber of sure safe states = " << num_sure << ".\n";
-            std::cout << "\t\tNumber of maybe safe states = " << num_maybe << ".\n";
+            /* the maybe winning states are not computed when all the initial states are sure winning */
+            if (all_init_sure_safe) {
+                std::cout << "\t\tNumber of maybe safe states = not computed.\n";
+            } else {
+                std::cout << "\t\tNumber of maybe safe states = " << num_maybe << ".\n";
+            }
         }
-        SafetyAutomaton* spoilers_safety = new SafetyAutomaton;
-        int flag1 = monitor.find_spoilers(sure_safe, maybe_safe, spoilers_safety);
+        SafetyAutomaton spoilers_safety;
+        int flag1 = monitor.find_spoilers(sure_safe, maybe_safe, &spoilers_safety);
         /* if some initial states are surely losing the safety specification, then return out_flag=0 */
         if (flag1==0) {
             out_flag=0;
@@ -354,19 +696,19 @@ public:
         if (verbose_>1 && flag1==1) {
             std::cout << "\t\tSome initial states are not surely safe.\n";
         }
-        spoilers_safety->trim();
+        spoilers_safety.trim();
         /* minimize the spoiler_safety automaton  */
-        negotiation::Spoilers safety(spoilers_safety);
+        negotiation::Spoilers safety(std::move(spoilers_safety));
         safety.boundedBisim();
         /* find the spoilers for the liveness part (with the strategies being already restricted by the strategy obtained during the synthesis of the maybe safety controller) */
-        SafetyAutomaton* spoilers_liveness = new SafetyAutomaton;
+        SafetyAutomaton spoilers_liveness;
         /* assume that the liveness game is winning */
         int flag2=2;
-        std::vector<std::unordered_set<abs_type>*> allowed_joint_inputs;
+        std::vector<arena_set*> allowed_joint_inputs;
         if (flag1==2) {
             /* if the safety game was sure winning, then the only restriction on input choices during the liveness game part comes from the sure winning strategy */
             for (abs_type i=0; i<monitor.no_states; i++) {
-                std::unordered_set<abs_type>* s = new std::unordered_set<abs_type>;
+                arena_set* s = monitor.new_set();
                 for (auto l=sure_safe[i]->begin(); l!=sure_safe[i]->end(); ++l) {
                     for (abs_type k=0; k<monitor.no_dist_inputs; k++) {
                         s->insert(monitor.addr_uw(*l,k));
@@ -377,13 +719,11 @@ public:
         } else {
             /* otherwise, the restriction on joint inputs come from the maybe winning strategy (the spoiler automaton comupted from the safety part will take care of the fact that the correct disturbance inputs are available at the correct point) */
             for (abs_type i=0; i<monitor.no_states; i++) {
-                std::unordered_set<abs_type>* s = new std::unordered_set<abs_type>;
-                *s=*maybe_safe[i];
-                allowed_joint_inputs.push_back(s);
+                allowed_joint_inputs.push_back(monitor.new_set(*maybe_safe[i]));
             }
         }
-        negotiation::LivenessGame monitor_live(monitor, *target_states_[c], sure_safe, allowed_joint_inputs);
-        flag2 = monitor_live.find_spoilers(spoilers_liveness);
+        negotiation::LivenessGame monitor_live(monitor, target_states, sure_safe, allowed_joint_inputs);
+        flag2 = monitor_live.find_spoilers(&spoilers_liveness);
         /* print debugging info */
         if (verbose_>1 && flag2==1) {
             std::cout << "\t\tSome initial states are not surely winning the liveness condition.\n";
@@ -393,18 +733,19 @@ public:
             out_flag=0;
             return out_flag;
         }
-        spoilers_liveness->trim();
+        spoilers_liveness.trim();
         /* minimize the spoiler_safety automaton  */
-        negotiation::Spoilers liveness(spoilers_liveness);
+        negotiation::Spoilers liveness(std::move(spoilers_liveness));
         liveness.boundedBisim();
         /* the overall spoiling behavior is the union of spoiling behavior for the safety spec and the liveness spec, or the overall non-spoiling behavior is the intersection of non-spoilers for safety AND non-spoilers for liveness */
         SafetyAutomaton spoilers_overall(*safety.spoilers_mini_, *liveness.spoilers_mini_);
         spoilers_overall.trim();
         /* minimize the spoiler_overall automaton  */
-        negotiation::Spoilers overall(&spoilers_overall);
+        negotiation::Spoilers overall(std::move(spoilers_overall));
         overall.boundedBisim();
-        /* copy the overall spoiling behavior to the one supplied as input for storing the spoiling behaviors */
-        *spoilers=*overall.spoilers_mini_;
+        /* move the overall spoiling behavior to the one supplied as input for storing the spoiling behaviors, with every disturbance input getting the transitions of its representative */
+        *spoilers=std::move(*overall.spoilers_mini_);
+        spoilers->expandInputs(dist_class);
         /* if both the safety and the liveness games are sure winning, then return out_flag=2, else return out_flag=1 */
         if (flag1==2 && flag2==2) {
             out_flag=2;
@@ -413,7 +754,35 @@ public:
         }
         return out_flag;
     }
-private:
+    /*! Solve the safety and the liveness games of solve_spoilers_overall on symbolic monitors, which decides the rounds in which all the initial states are sure winning or some initial state is losing.
+     * \param[in] comp              the component (restricted to the input representatives)
+     * \param[in] assume            the assumption (restricted to the input representatives)
+     * \param[in] guarantee         the guarantee
+     * \param[in] safe_states       the safe states of the component
+     * \param[in] target_states     the target states of the component
+     * \param[out] flag             0 -> some initial states are losing, 2 -> all initial states are sure winning, 1 -> otherwise (the spoilers are then computed by the explicit games) */
+    int decide_symbolically(negotiation::Component& comp, negotiation::SafetyAutomaton& assume, negotiation::SafetyAutomaton& guarantee, const std::unordered_set<abs_type>& safe_states, const std::unordered_set<abs_type>& target_states) {
+        negotiation::SymbolicSafetyGame monitor(comp,assume,guarantee);
+        Bdd sure_safe=monitor.solve_safety_game(safe_states,"sure");
+        bool all_init_sure_safe=monitor.contains_init(sure_safe.exists(monitor.control_cube_));
+        /* the liveness game is restricted as in solve_spoilers_overall: by the sure winning strategy if all the initial states are sure winning, and by the maybe winning strategy otherwise */
+        Bdd allowed_joint_inputs=sure_safe;
+        if (!all_init_sure_safe) {
+            allowed_joint_inputs=monitor.solve_safety_game(safe_states,"maybe");
+            if (!monitor.contains_init(allowed_joint_inputs.exists(monitor.control_cube_ & monitor.dist_cube_))) {
+                return 0;
+            }
+        }
+        negotiation::SymbolicLivenessGame monitor_live(monitor,target_states,sure_safe,allowed_joint_inputs);
+        if (monitor_live.contains_init(monitor_live.solve_liveness_game("sure"))) {
+            return (all_init_sure_safe ? 2 : 1);
+        }
+        /* the assumption violation is not a target for maybe winning (see LivenessGame::find_spoilers) */
+        if (!monitor_live.contains_init(monitor_live.solve_liveness_game("maybe",false))) {
+            return 0;
+        }
+        return 1;
+    }
     /*! Find the smallest element in a given set */
     template <class T>
     T smallest_element(const std::unordered_set<T>& set) {
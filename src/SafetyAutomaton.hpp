@@ -9,6 +9,8 @@
 
 #include <vector>
 #include <queue>
+#include <map>
+#include <algorithm>
 
 #include "Component.hpp" /* for the definition of data types abs_type and abs_ptr_type */
 
@@ -32,27 +34,22 @@ public:
     std::unordered_set<abs_type> init_;
     /** @brief number of internal disturbance inputs P **/
     abs_type no_inputs_;
-    /** @brief post set: post[(i-1)*P+j] contains the list of posts for state i and dist_input j **/
-    std::unordered_set<abs_type>** post_;
+    /** @brief post set: post[(i-1)*P+j] contains the list of posts for state i and dist_input j (stored contiguously) **/
+    std::vector<std::unordered_set<abs_type>> post_;
 public:
-    /*! Copy constructor
-     * \param[in] other   The safety automaton whose attribues are to be copied*/
-    SafetyAutomaton(const SafetyAutomaton& other) {
-        no_states_=other.no_states_;
-        init_=other.init_;
-        no_inputs_=other.no_inputs_;
-        post_ = new std::unordered_set<abs_type>*[no_states_*no_inputs_];
-        for (abs_type i=0; i<no_states_*no_inputs_; i++) {
-            std::unordered_set<abs_type>* p=new std::unordered_set<abs_type>;
-            *p=*other.post_[i];
-            post_[i]=p;
-        }
-    }
     /*! Default constructor */
     SafetyAutomaton() {
         no_states_=0;
         no_inputs_=0;
     }
+    /*! Copy constructor (deep copy)
+     * \param[in] other   The safety automaton whose attribues are to be copied*/
+    SafetyAutomaton(const SafetyAutomaton& other)=default;
+    /*! Move constructor: the transitions are taken over from other in constant time, and other is left as an empty automaton
+     * \param[in] other   The safety automaton whose attribues are to be moved*/
+    SafetyAutomaton(SafetyAutomaton&& other) noexcept : no_states_(other.no_states_), init_(std::move(other.init_)), no_inputs_(other.no_inputs_), post_(std::move(other.post_)) {
+        other.clear();
+    }
     /*! Constructor: all strings are accepted.
      * \param[in] no_dist_inputs        number of disturbance inputs. */
     SafetyAutomaton(const abs_type no_dist_inputs) {
@@ -61,18 +58,13 @@ public:
         /* state 1 is initial */
         init_.insert(1);
         no_inputs_=no_dist_inputs;
-        std::unordered_set<abs_type>** post = new std::unordered_set<abs_type>*[no_states_*no_inputs_];
+        post_.resize(abs_ptr_type(no_states_)*no_inputs_);
         for (abs_type i=0; i<no_states_; i++) {
             for (abs_type j=0; j<no_inputs_; j++) {
                 /* add self loop to state i on input j */
-                std::unordered_set<abs_type>* s=new std::unordered_set<abs_type>;
-                s->insert(i);
-                post[addr(i,j)]=s;
+                post_[addr(i,j)].insert(i);
             }
         }
-        addPost(post);
-
-        delete[] post;
     }
     /*! Constructor: product of two safety automata
      * \param[in] A1      The first safety automaton
@@ -96,20 +88,20 @@ public:
         negotiation::SafetyAutomaton A2_local(A2);
         for (abs_type i=0; i<A1_local.no_states_; i++) {
             for (abs_type j=0; j<A1_local.no_inputs_; j++) {
-                if (A1_local.post_[A1_local.addr(i,j)]->size()==0) {
-                    A1_local.post_[A1_local.addr(i,j)]->insert(0);
+                if (A1_local.post_[A1_local.addr(i,j)].size()==0) {
+                    A1_local.post_[A1_local.addr(i,j)].insert(0);
                 }
             }
         }
         for (abs_type i=0; i<A2_local.no_states_; i++) {
             for (abs_type j=0; j<A2_local.no_inputs_; j++) {
-                if (A2_local.post_[A2_local.addr(i,j)]->size()==0) {
-                    A2_local.post_[A2_local.addr(i,j)]->insert(0);
+                if (A2_local.post_[A2_local.addr(i,j)].size()==0) {
+                    A2_local.post_[A2_local.addr(i,j)].insert(0);
                 }
             }
         }
         /* the number of states of the product is the product of the number of states of A1_local and A2_local */
-        no_states_ = (A1_local.no_states_-1)*(A2_local.no_states_-1)+1;
+        no_states_ = abs_type(checked_product({A1_local.no_states_-1,A2_local.no_states_-1},std::numeric_limits<abs_type>::max()-1,"SafetyAutomaton: product: the number of states")+1);
         /* the new state index is derived using the following lambda expression */
         auto new_ind = [&](abs_type i1, abs_type i2) -> abs_type {
             if (i1==0 || i2==0) {
@@ -127,45 +119,40 @@ public:
             }
         }
         /* compute the post */
-        std::unordered_set<abs_type>** post = new std::unordered_set<abs_type>*[no_states_*no_inputs_];
+        post_.resize(abs_ptr_type(no_states_)*no_inputs_);
         /* first add self loops to the sink state (state index 0) */
         for (abs_type j=0; j<no_inputs_; j++) {
-            std::unordered_set<abs_type>* set = new std::unordered_set<abs_type>;
-            set->insert(0);
-            post[addr(0,j)]=set;
+            post_[addr(0,j)].insert(0);
         }
         /* compute post for the non-sink states */
-        abs_type index = no_inputs_;
+        abs_ptr_type index = no_inputs_;
         for (abs_type i1=1; i1<A1_local.no_states_; i1++) {
             for (abs_type i2=1; i2<A2_local.no_states_; i2++) {
                 for (abs_type j=0; j<no_inputs_; j++) {
-                    std::unordered_set<abs_type>* set = new std::unordered_set<abs_type>;
-                    abs_type p1 = A1_local.addr(i1,j);
-                    for (auto l1=A1_local.post_[p1]->begin(); l1!=A1_local.post_[p1]->end(); ++l1) {
-                        abs_type p2 = A2_local.addr(i2,j);
-                        for (auto l2=A2_local.post_[p2]->begin(); l2!=A2_local.post_[p2]->end(); ++l2) {
-                            set->insert(new_ind(*l1,*l2));
+                    abs_ptr_type p1 = A1_local.addr(i1,j);
+                    for (auto l1=A1_local.post_[p1].begin(); l1!=A1_local.post_[p1].end(); ++l1) {
+                        abs_ptr_type p2 = A2_local.addr(i2,j);
+                        for (auto l2=A2_local.post_[p2].begin(); l2!=A2_local.post_[p2].end(); ++l2) {
+                            post_[index].insert(new_ind(*l1,*l2));
                         }
                     }
-                    post[index]=set;
                     index++;
                 }
             }
         }
-        addPost(post);
-        delete[] post;
     }
-    /*! The equality operator for equating two safety automata
+    /*! The equality operator for equating two safety automata (deep copy)
      * \param[in] other   The safety automata from the right hand side*/
-    SafetyAutomaton& operator=(const SafetyAutomaton& other) {
-        no_states_=other.no_states_;
-        init_=other.init_;
-        no_inputs_=other.no_inputs_;
-        post_ = new std::unordered_set<abs_type>*[no_states_*no_inputs_];
-        for (abs_type i=0; i<no_states_*no_inputs_; i++) {
-            std::unordered_set<abs_type>* p=new std::unordered_set<abs_type>;
-            *p=*other.post_[i];
-            post_[i]=p;
+    SafetyAutomaton& operator=(const SafetyAutomaton& other)=default;
+    /*! Move assignment: the transitions are taken over from other in constant time, and other is left as an empty automaton
+     * \param[in] other   The safety automata from the right hand side*/
+    SafetyAutomaton& operator=(SafetyAutomaton&& other) noexcept {
+        if (this!=&other) {
+            no_states_=other.no_states_;
+            init_=std::move(other.init_);
+            no_inputs_=other.no_inputs_;
+            post_=std::move(other.post_);
+            other.clear();
         }
         return *this;
     }
@@ -177,15 +164,12 @@ public:
         result = readMember<abs_type>(filename, ni, "NO_INITIAL_STATES");
         result = readSet<abs_type>(filename, init_, ni, "INITIAL_STATE_LIST");
         result = readMember<abs_type>(filename, no_inputs_, "NO_INPUTS");
-        abs_type no_elems = no_states_*no_inputs_;
-        post_ = new std::unordered_set<abs_type>*[no_elems];
-        for (size_t i=0; i<no_elems; i++) {
-            std::unordered_set<abs_type> *v=new std::unordered_set<abs_type>;
-            post_[i]=v;
-        }
-        result = readArrSet<abs_type>(filename, post_, no_elems, "TRANSITION_POST");
+        abs_ptr_type no_elems = checked_product({no_states_,no_inputs_},std::numeric_limits<size_t>::max()/sizeof(std::unordered_set<abs_type>),"SafetyAutomaton: the number of state-input pairs");
+        post_.assign(no_elems,std::unordered_set<abs_type>());
+        std::vector<std::unordered_set<abs_type>*> post_ptr=postPointers();
+        result = readArrSet<abs_type>(filename, post_ptr.data(), no_elems, "TRANSITION_POST");
         for (size_t i=0; i<no_elems; i++) {
-            for (auto it=post_[i]->begin(); it!=post_[i]->end(); ++it) {
+            for (auto it=post_[i].begin(); it!=post_[i].end(); ++it) {
                 if (*it >=no_states_) {
                     try {
                         throw std::runtime_error("SafetAutomaton: One of the post state indices is out of bound.");
@@ -196,27 +180,28 @@ public:
             }
         }
     }
-    /*! Destructor */
-    ~SafetyAutomaton() {
-        delete[] post_;
-    }
     /*! Reset post */
     void resetPost() {
-        delete[] post_;
+        post_.clear();
     }
-    /*! Overwrite the post array.
+    /*! Overwrite the post array (the supplied array is copied).
      * \param[in] post      the new post array */
-    void addPost(std::unordered_set<abs_type>** post) {
+    template<class Set>
+    void addPost(Set** post) {
         /* now set the new post as the one supplied */
-        int no_elems = no_states_*no_inputs_;
-        post_ = new std::unordered_set<abs_type>*[no_elems];
-        for (int i=0; i<no_elems; i++) {
-            std::unordered_set<abs_type>* v=new std::unordered_set<abs_type>;
-            post_[i]=v;
+        size_t no_elems = abs_ptr_type(no_states_)*no_inputs_;
+        std::vector<std::unordered_set<abs_type>> post_new(no_elems);
+        for (size_t i=0; i<no_elems; i++) {
             for (auto it=post[i]->begin(); it!=post[i]->end(); ++it) {
-                post_[i]->insert(*it);
+                post_new[i].insert(*it);
             }
         }
+        post_=std::move(post_new);
+    }
+    /*! Overwrite the post array (the supplied vector is moved in constant time).
+     * \param[in] post      the new post array */
+    void addPost(std::vector<std::unordered_set<abs_type>>&& post) {
+        post_=std::move(post);
     }
     /*! Trim the unreachable part of a safety automaton.
      *  The result is used to update the safety automaton. */
@@ -239,8 +224,8 @@ public:
             /* add all the successors of i to the queue */
             for (abs_type j=0; j<no_inputs_; j++) {
                 /* address in the post array */
-                abs_type post_addr = addr(i,j);
-                for (auto i2=post_[post_addr]->begin(); i2!=post_[post_addr]->end(); ++i2) {
+                abs_ptr_type post_addr = addr(i,j);
+                for (auto i2=post_[post_addr].begin(); i2!=post_[post_addr].end(); ++i2) {
                     /* if the state i2 is not seen, then add i2 to the queue and seen */
                     if (seen.find(*i2)==seen.end()) {
                         fifo.push(*i2);
@@ -251,7 +236,7 @@ public:
         }
         /* the set seen is the set of reachable states, and serves as the new state space */
         std::vector<abs_type> new_to_old;
-        abs_type* old_to_new = new abs_type[no_states_];
+        std::vector<abs_type> old_to_new(no_states_);
         /* the new reject state is mapped to the old reject state */
         new_to_old.push_back(0);
         old_to_new[0]=0;
@@ -271,22 +256,18 @@ public:
         }
         /* number of inputs remain the same: one benefit of this is that we can use the function addr for computing both the new and old address of post in the post array. */
         /* update the post array */
-        std::unordered_set<abs_type>** post_new = new std::unordered_set<abs_type>*[no_states_*no_inputs_];
+        std::vector<std::unordered_set<abs_type>> post_new(abs_ptr_type(no_states_)*no_inputs_);
         for (abs_type i_new=0; i_new<no_states_; i_new++) {
             abs_type i_old=new_to_old[i_new];
             for (abs_type j=0; j<no_inputs_; j++) {
-                abs_type addr_post_old=addr(i_old,j);
-                abs_type addr_post_new=addr(i_new,j);
-                std::unordered_set<abs_type>* set = new std::unordered_set<abs_type>;
-                for (auto i2=post_[addr_post_old]->begin(); i2!=post_[addr_post_old]->end(); ++i2) {
-                    set->insert(old_to_new[*i2]);
+                abs_ptr_type addr_post_old=addr(i_old,j);
+                abs_ptr_type addr_post_new=addr(i_new,j);
+                for (auto i2=post_[addr_post_old].begin(); i2!=post_[addr_post_old].end(); ++i2) {
+                    post_new[addr_post_new].insert(old_to_new[*i2]);
                 }
-                post_new[addr_post_new]=set;
             }
         }
-        addPost(post_new);
-        delete[] post_new;
-        delete[] old_to_new;
+        addPost(std::move(post_new));
     }
     /*! Determinize the safety automaton (using the universal accepting condition) */
     void determinize() {
@@ -317,7 +298,7 @@ public:
                 /* flag to check if any successor goes to reject */
                 bool unsafe=false;
                 for (auto i=cur_state->begin(); i!=cur_state->end(); ++i) {
-                    std::unordered_set<abs_type>* post_set=post_[addr(*i,j)];
+                    const std::unordered_set<abs_type>* post_set=&post_[addr(*i,j)];
                     for (auto k=post_set->begin(); k!=post_set->end(); ++k) {
                         /* if the successor is bad, then all the other successors are bad */
                         if (*k==0) {
@@ -334,6 +315,7 @@ public:
                 }
                 if (unsafe) {
                     post_det.push_back(0);
+                    delete post;
                 } else {
                     /* check if the set post has been seen before or not */
                     bool seen_before=false;
@@ -350,6 +332,8 @@ public:
                         Q.push_back(post);
                         next_state_id=Q.size()-1;
                         E.push(post);
+                    } else {
+                        delete post;
                     }
                     /* add the transition */
                     post_det.push_back(next_state_id);
@@ -360,18 +344,285 @@ public:
         no_states_=Q.size();
         init_.clear();
         init_.insert(1);
-        /* convert post_det to an array */
-        std::unordered_set<abs_type>** post_det_arr = new std::unordered_set<abs_type>*[post_det.size()];
+        /* convert post_det to sets, and replace the current post with the deterministic version */
+        std::vector<std::unordered_set<abs_type>> post_det_sets(post_det.size());
         for (size_t i=0; i<post_det.size(); i++) {
-            std::unordered_set<abs_type>* s=new std::unordered_set<abs_type>;
-            s->insert(post_det[i]);
-            post_det_arr[i]=s;
+            post_det_sets[i].insert(post_det[i]);
         }
-        /* replace the current post with the deterministic version */
-        resetPost();
-        addPost(post_det_arr);
-
-        delete[] post_det_arr;
+        addPost(std::move(post_det_sets));
+        for (size_t i=0; i<Q.size(); i++) {
+            delete Q[i];
+        }
+        delete s;
+    }
+    /*! Deterministic automaton of the intersection of this automaton with another one.
+     *
+     * Same as the product constructor followed by trim and determinize, but the subset construction runs directly over the pairs of states of the two automata, so that neither the product nor its unreachable part are built. The deterministic states are numbered in the same order as by determinize (0 is the reject state, 1 is the set of initial pairs, and the rest in breadth-first order). Optionally, the result is minimized by merging the states with the same language (see minimize).
+     * \param[in] other     the second automaton, over the same inputs (missing transitions of either automaton go to the reject state)
+     * \param[in] min       [Optional] whether the result is minimized (default: true)
+     * \param[out] A        the deterministic automaton */
+    SafetyAutomaton determinizedProduct(const SafetyAutomaton& other, const bool min=true) const {
+        if (no_inputs_!=other.no_inputs_) {
+            throw std::runtime_error("SafetyAutomaton:determinizedProduct: the input spaces of the automata do not match.");
+        }
+        /* the pairs of non-reject states are indexed as in the product constructor, and 0 stands for all the pairs with a reject state */
+        const abs_ptr_type n2=(other.no_states_==0 ? 0 : other.no_states_-1);
+        auto pair_ind = [&](const abs_type i1, const abs_type i2) -> abs_ptr_type {
+            return (i1==0 || i2==0) ? 0 : abs_ptr_type(i1-1)*n2+(i2-1)+1;
+        };
+        /* the deterministic states (sorted sets of pairs) and their indices */
+        std::vector<std::vector<abs_ptr_type>> Q;
+        std::map<std::vector<abs_ptr_type>,abs_type> index;
+        Q.push_back(std::vector<abs_ptr_type>(1,0));
+        std::vector<abs_ptr_type> init;
+        for (auto i1=init_.begin(); i1!=init_.end(); ++i1) {
+            for (auto i2=other.init_.begin(); i2!=other.init_.end(); ++i2) {
+                init.push_back(pair_ind(*i1,*i2));
+            }
+        }
+        std::sort(init.begin(),init.end());
+        init.erase(std::unique(init.begin(),init.end()),init.end());
+        Q.push_back(init);
+        /* a set seen more than once keeps its first index */
+        index.insert(std::make_pair(Q[0],0));
+        index.insert(std::make_pair(Q[1],1));
+        /* the missing transitions go to the reject state */
+        const std::unordered_set<abs_type> reject={0};
+        std::vector<abs_type> post_det;
+        std::vector<abs_ptr_type> post;
+        /* Q doubles as the queue of the breadth-first search */
+        for (size_t q=0; q<Q.size(); q++) {
+            for (abs_type j=0; j<no_inputs_; j++) {
+                post.clear();
+                bool unsafe=false;
+                for (size_t n=0; n<Q[q].size() && !unsafe; n++) {
+                    abs_ptr_type p=Q[q][n];
+                    if (p==0) {
+                        unsafe=true;
+                        break;
+                    }
+                    const std::unordered_set<abs_type>& p1=post_[addr(abs_type((p-1)/n2+1),j)];
+                    const std::unordered_set<abs_type>& p2=other.post_[other.addr(abs_type((p-1)%n2+1),j)];
+                    const std::unordered_set<abs_type>& q1=(p1.size()==0 ? reject : p1);
+                    const std::unordered_set<abs_type>& q2=(p2.size()==0 ? reject : p2);
+                    for (auto l1=q1.begin(); l1!=q1.end() && !unsafe; ++l1) {
+                        for (auto l2=q2.begin(); l2!=q2.end(); ++l2) {
+                            abs_ptr_type l=pair_ind(*l1,*l2);
+                            if (l==0) {
+                                unsafe=true;
+                                break;
+                            }
+                            post.push_back(l);
+                        }
+                    }
+                }
+                if (unsafe) {
+                    post_det.push_back(0);
+                    continue;
+                }
+                std::sort(post.begin(),post.end());
+                post.erase(std::unique(post.begin(),post.end()),post.end());
+                auto it=index.insert(std::make_pair(post,abs_type(Q.size())));
+                if (it.second) {
+                    Q.push_back(post);
+                }
+                post_det.push_back(it.first->second);
+            }
+        }
+        SafetyAutomaton A;
+        A.no_states_=Q.size();
+        A.no_inputs_=no_inputs_;
+        A.init_.insert(1);
+        A.post_.resize(post_det.size());
+        for (size_t l=0; l<post_det.size(); l++) {
+            A.post_[l].insert(post_det[l]);
+        }
+        if (min) {
+            A.minimize();
+        }
+        return A;
+    }
+    /*! Minimize a deterministic automaton by merging the states with the same language (Moore's partition refinement, starting from the partition into the reject state and the rest).
+     *
+     * Every state must have exactly one post per input (as after determinize). The states are renumbered by the smallest index in their class, so that the reject state keeps the index 0 and the order of the states is preserved. */
+    void minimize() {
+        std::vector<abs_type> cls(no_states_);
+        for (abs_type i=0; i<no_states_; i++) {
+            cls[i]=(i==0 ? 0 : 1);
+        }
+        cls=classes_of_equal_keys(cls);
+        abs_type no_classes=class_representatives(cls).size();
+        while (1) {
+            std::vector<std::vector<abs_type>> keys(no_states_);
+            for (abs_type i=0; i<no_states_; i++) {
+                keys[i].push_back(cls[i]);
+                for (abs_type j=0; j<no_inputs_; j++) {
+                    keys[i].push_back(cls[*post_[addr(i,j)].begin()]);
+                }
+            }
+            cls=classes_of_equal_keys(keys);
+            abs_type no_classes_new=class_representatives(cls).size();
+            if (no_classes_new==no_classes) {
+                break;
+            }
+            no_classes=no_classes_new;
+        }
+        if (no_classes==no_states_) {
+            return;
+        }
+        std::vector<abs_type> reps=class_representatives(cls);
+        std::vector<std::unordered_set<abs_type>> post_new(abs_ptr_type(no_classes)*no_inputs_);
+        for (abs_type c=0; c<no_classes; c++) {
+            for (abs_type j=0; j<no_inputs_; j++) {
+                post_new[abs_ptr_type(c)*no_inputs_+j].insert(cls[*post_[addr(reps[c],j)].begin()]);
+            }
+        }
+        std::unordered_set<abs_type> init_old=init_;
+        init_.clear();
+        for (auto i=init_old.begin(); i!=init_old.end(); ++i) {
+            init_.insert(cls[*i]);
+        }
+        no_states_=no_classes;
+        addPost(std::move(post_new));
+    }
+    /*! Simulation preorder of the states: the language of state q is contained in the language of state r if r simulates q.
+     *
+     * A set of states accepts a word only if all of its states do (as in determinize), and a missing transition goes to the reject state. Hence r simulates q if q is the reject state, or if r is not the reject state and for every input for which q does not reject, r does not reject either and every post state of r simulates some post state of q. The preorder is the greatest such relation.
+     *
+     * It is computed by counter-based refinement (in the spirit of Henzinger, Henzinger and Kopke): for every state q, input j and state r2, the counter (q,j,r2) holds the number of post states of q on j which are still simulated by r2. Every pair removed from the relation decrements the counters of the predecessors of its first state, and a counter dropping to 0 removes the pairs (q,r) for the predecessors r of r2 on j. Every pair is removed at most once, so the running time is O(m*N) for m transitions instead of one quadratic pass per removed pair; the counters take N*N*M words (see reduceBySimulation).
+     * \param[out] sim     vector[N*N] containing at q*N+r whether r simulates q */
+    std::vector<bool> simulation() const {
+        const abs_ptr_type n=no_states_;
+        /* whether the post of state i on input j contains the reject state */
+        auto rejects = [&](const abs_type i, const abs_type j) -> bool {
+            const std::unordered_set<abs_type>& p=post_[addr(i,j)];
+            return (i==0 || p.size()==0 || p.find(0)!=p.end());
+        };
+        /* the predecessors of the states on each input, only from the states not rejecting on that input: pre[j*N+x] */
+        std::vector<std::vector<abs_type>> pre(abs_ptr_type(no_inputs_)*n);
+        for (abs_type i=0; i<n; i++) {
+            for (abs_type j=0; j<no_inputs_; j++) {
+                if (rejects(i,j)) {
+                    continue;
+                }
+                for (auto i2=post_[addr(i,j)].begin(); i2!=post_[addr(i,j)].end(); ++i2) {
+                    pre[abs_ptr_type(j)*n+*i2].push_back(i);
+                }
+            }
+        }
+        /* initially every pair is assumed to be in the relation, so that the counter (q,j,r2) at (q*M+j)*N+r2 is the number of post states of q on j */
+        std::vector<abs_type> count(abs_ptr_type(n)*no_inputs_*n,0);
+        for (abs_type q=1; q<n; q++) {
+            for (abs_type j=0; j<no_inputs_; j++) {
+                if (!rejects(q,j)) {
+                    std::fill(count.begin()+(abs_ptr_type(q)*no_inputs_+j)*n,count.begin()+(abs_ptr_type(q)*no_inputs_+j+1)*n,abs_type(post_[addr(q,j)].size()));
+                }
+            }
+        }
+        /* the pairs violating the conditions on the rejecting inputs are removed right away */
+        std::vector<bool> sim(n*n,true);
+        std::vector<std::pair<abs_type,abs_type>> removed;
+        for (abs_type q=1; q<n; q++) {
+            for (abs_type r=0; r<n; r++) {
+                bool ok=(r!=0 || q==r);
+                for (abs_type j=0; j<no_inputs_ && ok && r!=q; j++) {
+                    ok=(rejects(q,j) || !rejects(r,j));
+                }
+                if (!ok) {
+                    sim[q*n+r]=false;
+                    removed.push_back(std::make_pair(q,r));
+                }
+            }
+        }
+        /* the pair (q2,r2) was removed: r2 no longer simulates q2 */
+        while (removed.size()!=0) {
+            const abs_type q2=removed.back().first;
+            const abs_type r2=removed.back().second;
+            removed.pop_back();
+            for (abs_type j=0; j<no_inputs_; j++) {
+                const std::vector<abs_type>& pre_q2=pre[abs_ptr_type(j)*n+q2];
+                for (size_t a=0; a<pre_q2.size(); a++) {
+                    const abs_type q=pre_q2[a];
+                    if (--count[(abs_ptr_type(q)*no_inputs_+j)*n+r2]!=0) {
+                        continue;
+                    }
+                    /* no post state of q on j is simulated by r2 any more: the states having r2 as a post state on j do not simulate q */
+                    const std::vector<abs_type>& pre_r2=pre[abs_ptr_type(j)*n+r2];
+                    for (size_t b=0; b<pre_r2.size(); b++) {
+                        const abs_type r=pre_r2[b];
+                        if (sim[q*n+r]) {
+                            sim[q*n+r]=false;
+                            removed.push_back(std::make_pair(q,r));
+                        }
+                    }
+                }
+            }
+        }
+        return sim;
+    }
+    /*! Reduce the safety automaton using the simulation preorder (see simulation), without changing its language.
+     *
+     * The simulation-equivalent states are merged into the smallest one. From a set of post states (or of initial states), a state is removed if it simulates another state of the set, since it does not restrict the intersection of their languages; a post set with the reject state becomes just the reject state. Finally the unreachable states are removed (see trim).
+     *
+     * The reduction is skipped (the automaton is left as it is) when the counters of simulation would exceed max_counters words, as it is only an optimization before the subset construction.
+     * \param[in] max_counters  [Optional] the largest N*N*M for which the reduction is done (default: 2^26, i.e. 256 MiB of counters) */
+    void reduceBySimulation(const abs_ptr_type max_counters=abs_ptr_type(1)<<26) {
+        if (no_states_==0) {
+            return;
+        }
+        try {
+            checked_product({no_states_,no_states_,no_inputs_},max_counters,"SafetyAutomaton:reduceBySimulation: the number of counters");
+        } catch (std::overflow_error&) {
+            return;
+        }
+        const abs_ptr_type n=no_states_;
+        std::vector<bool> sim=simulation();
+        std::vector<abs_type> rep(no_states_);
+        for (abs_type q=0; q<no_states_; q++) {
+            rep[q]=q;
+            for (abs_type r=0; r<q; r++) {
+                if (sim[q*n+r] && sim[r*n+q]) {
+                    rep[q]=rep[r];
+                    break;
+                }
+            }
+        }
+        /* the representatives of a set of states without the ones simulating another one */
+        auto prune = [&](const std::unordered_set<abs_type>& S) -> std::unordered_set<abs_type> {
+            std::unordered_set<abs_type> R;
+            for (auto i=S.begin(); i!=S.end(); ++i) {
+                R.insert(rep[*i]);
+            }
+            if (R.size()==0 || R.find(0)!=R.end()) {
+                return std::unordered_set<abs_type>({0});
+            }
+            std::unordered_set<abs_type> P;
+            for (auto i=R.begin(); i!=R.end(); ++i) {
+                bool dominated=false;
+                for (auto i2=R.begin(); i2!=R.end(); ++i2) {
+                    if (*i2!=*i && sim[*i2*n+*i]) {
+                        dominated=true;
+                        break;
+                    }
+                }
+                if (!dominated) {
+                    P.insert(*i);
+                }
+            }
+            return P;
+        };
+        /* the merged states keep their indices, but are unreachable afterwards */
+        for (abs_type q=0; q<no_states_; q++) {
+            for (abs_type j=0; j<no_inputs_; j++) {
+                if (q==0 || rep[q]!=q) {
+                    post_[addr(q,j)]=std::unordered_set<abs_type>({0});
+                } else {
+                    post_[addr(q,j)]=prune(post_[addr(q,j)]);
+                }
+            }
+        }
+        init_=prune(init_);
+        trim();
     }
     /*! Existential predecessor of the full transition system
      * \param[in] S1        a given set of state indices of the safety automaton
@@ -380,7 +631,7 @@ public:
         S2.clear();
         for (abs_type i=0; i<no_states_; i++) {
             for (abs_type j=0; j<no_inputs_; j++) {
-                for (auto i2=post_[addr(i,j)]->begin(); i2!=post_[addr(i,j)]->end(); ++i2) {
+                for (auto i2=post_[addr(i,j)].begin(); i2!=post_[addr(i,j)].end(); ++i2) {
                     if (S1.find(*i2)!=S1.end()) {
                         S2.insert(i);
                     }
@@ -395,7 +646,154 @@ public:
         writeMember(filename, "NO_INITIAL_STATES", init_.size());
         writeSet(filename, "INITIAL_STATE_LIST", init_);
         writeMember<abs_type>(filename, "NO_INPUTS", no_inputs_);
-        writeArrSet(filename,"TRANSITION_POST",post_, no_states_*no_inputs_);
+        std::vector<std::unordered_set<abs_type>*> post_ptr=postPointers();
+        writeArrSet(filename,"TRANSITION_POST",post_ptr.data(), abs_ptr_type(no_states_)*no_inputs_);
+    }
+    /*! Write the safety automaton to a binary stream
+     * \param[in] out    the output stream (opened in binary mode)
+     *
+     * The format is: no. of states, no. of inputs, no. of initial states, initial states, then for each state and each input the no. of posts followed by the posts; all numbers are stored as raw abs_type values. */
+    void writeBinary(std::ostream& out) const {
+        std::vector<abs_type> v;
+        v.push_back(no_states_);
+        v.push_back(no_inputs_);
+        v.push_back(init_.size());
+        v.insert(v.end(),init_.begin(),init_.end());
+        for (abs_ptr_type l=0; l<abs_ptr_type(no_states_)*no_inputs_; l++) {
+            v.push_back(post_[l].size());
+            v.insert(v.end(),post_[l].begin(),post_[l].end());
+        }
+        out.write(reinterpret_cast<const char*>(v.data()),v.size()*sizeof(abs_type));
+    }
+    /*! Read the safety automaton from a binary stream written by writeBinary
+     *
+     * The sizes in the header are checked against the remaining length of the stream (when it can be determined) before anything is allocated, so that a truncated or corrupted stream is rejected instead of being trusted.
+     * \param[in] in     the input stream (opened in binary mode)
+     * \param[out] success    false if the stream ended prematurely, its sizes do not fit into the stream, or it contained an out of bound state index */
+    bool readBinary(std::istream& in) {
+        auto read = [&](abs_type& x) -> bool {
+            in.read(reinterpret_cast<char*>(&x),sizeof(abs_type));
+            return static_cast<bool>(in);
+        };
+        abs_type ns, ni, n_init;
+        if (!read(ns) || !read(ni) || !read(n_init)) {
+            return false;
+        }
+        /* the number of words left in the stream (unbounded if the stream is not seekable) */
+        abs_ptr_type remaining=std::numeric_limits<abs_ptr_type>::max();
+        const std::streampos pos=in.tellg();
+        if (pos!=std::streampos(-1)) {
+            in.seekg(0,std::ios::end);
+            const std::streampos end=in.tellg();
+            in.seekg(pos);
+            if (!in || end<pos) {
+                return false;
+            }
+            remaining=abs_ptr_type(end-pos)/sizeof(abs_type);
+        }
+        /* every initial state and every state-input pair takes at least one word */
+        if (n_init>remaining) {
+            return false;
+        }
+        abs_ptr_type no_elems;
+        try {
+            no_elems=checked_product({ns,ni},std::min(remaining-n_init,abs_ptr_type(std::numeric_limits<size_t>::max()/sizeof(std::unordered_set<abs_type>))),"SafetyAutomaton:readBinary: the number of state-input pairs");
+        } catch (std::overflow_error&) {
+            return false;
+        }
+        std::unordered_set<abs_type> init;
+        for (abs_type i=0; i<n_init; i++) {
+            abs_type x;
+            if (!read(x) || x>=ns) {
+                return false;
+            }
+            init.insert(x);
+        }
+        std::vector<std::unordered_set<abs_type>> post(no_elems);
+        for (abs_ptr_type l=0; l<no_elems; l++) {
+            abs_type n;
+            if (!read(n)) {
+                return false;
+            }
+            for (abs_type i=0; i<n; i++) {
+                abs_type x;
+                if (!read(x) || x>=ns) {
+                    return false;
+                }
+                post[l].insert(x);
+            }
+        }
+        no_states_=ns;
+        no_inputs_=ni;
+        init_=init;
+        addPost(std::move(post));
+        return true;
+    }
+    /*! Canonical encoding of the safety automaton.
+     *
+     * The states are renumbered in the breadth-first order in which they are discovered from the initial states, with the successors of every state-input pair being visited in increasing order of their original indices (the reject state 0 keeps its index). Two automata which are equal up to such a renumbering have the same encoding. States which are not reachable are appended in the end in their original order.
+     * \param[out] enc     the vector [no. of states, no. of inputs, no. of initial states, initial states, then for each state and each input the no. of posts followed by the posts] */
+    std::vector<abs_type> canonicalEncoding() const {
+        /* the new index of every old state index (no_states_ marks the states not numbered yet) */
+        std::vector<abs_type> old_to_new(no_states_,no_states_);
+        std::vector<abs_type> new_to_old;
+        if (no_states_!=0) {
+            old_to_new[0]=0;
+            new_to_old.push_back(0);
+        }
+        std::vector<abs_type> init_sorted(init_.begin(),init_.end());
+        std::sort(init_sorted.begin(),init_sorted.end());
+        for (size_t i=0; i<init_sorted.size(); i++) {
+            if (old_to_new[init_sorted[i]]==no_states_) {
+                old_to_new[init_sorted[i]]=new_to_old.size();
+                new_to_old.push_back(init_sorted[i]);
+            }
+        }
+        /* breadth-first search: new_to_old works as the FIFO queue */
+        for (size_t q=0; q<new_to_old.size(); q++) {
+            abs_type i=new_to_old[q];
+            for (abs_type j=0; j<no_inputs_; j++) {
+                std::vector<abs_type> p(post_[addr(i,j)].begin(),post_[addr(i,j)].end());
+                std::sort(p.begin(),p.end());
+                for (size_t l=0; l<p.size(); l++) {
+                    if (old_to_new[p[l]]==no_states_) {
+                        old_to_new[p[l]]=new_to_old.size();
+                        new_to_old.push_back(p[l]);
+                    }
+                }
+            }
+        }
+        /* append the unreachable states */
+        for (abs_type i=0; i<no_states_; i++) {
+            if (old_to_new[i]==no_states_) {
+                old_to_new[i]=new_to_old.size();
+                new_to_old.push_back(i);
+            }
+        }
+        /* write the encoding */
+        std::vector<abs_type> enc;
+        enc.push_back(no_states_);
+        enc.push_back(no_inputs_);
+        enc.push_back(init_.size());
+        std::vector<abs_type> v;
+        for (size_t i=0; i<init_sorted.size(); i++) {
+            v.push_back(old_to_new[init_sorted[i]]);
+        }
+        std::sort(v.begin(),v.end());
+        enc.insert(enc.end(),v.begin(),v.end());
+        for (abs_type i_new=0; i_new<no_states_; i_new++) {
+            abs_type i=new_to_old[i_new];
+            for (abs_type j=0; j<no_inputs_; j++) {
+                v.clear();
+                for (auto l=post_[addr(i,j)].begin(); l!=post_[addr(i,j)].end(); ++l) {
+                    v.push_back(old_to_new[*l]);
+                }
+                std::sort(v.begin(),v.end());
+                enc.push_back(v.size());
+                enc.insert(enc.end(),v.begin(),v.end());
+            }
+        }
+        return enc;
     }
     /*! Decimal encoding of set of states
      * \param[in] S   set of states
@@ -409,12 +807,113 @@ public:
         }
         return d;
     }
+    /*! Refine a partition of the inputs, so that two inputs stay in the same class only if they have identical transitions from every state.
+     * \param[in,out] input_class   vector[P] containing the class of each input (see classes_of_equal_keys) */
+    void refineInputClasses(std::vector<abs_type>& input_class) const {
+        std::vector<std::vector<abs_type>> keys(no_inputs_);
+        for (abs_type j=0; j<no_inputs_; j++) {
+            keys[j].push_back(input_class[j]);
+            for (abs_type i=0; i<no_states_; i++) {
+                std::vector<abs_type> p(post_[addr(i,j)].begin(),post_[addr(i,j)].end());
+                std::sort(p.begin(),p.end());
+                keys[j].push_back(p.size());
+                keys[j].insert(keys[j].end(),p.begin(),p.end());
+            }
+        }
+        input_class=classes_of_equal_keys(keys);
+    }
+    /*! Restriction of the safety automaton to a subset of its inputs
+     * \param[in] inputs    the inputs which are kept (input j of the result is input inputs[j] of this automaton)
+     * \param[out] A        the restricted safety automaton */
+    SafetyAutomaton restrictInputs(const std::vector<abs_type>& inputs) const {
+        SafetyAutomaton A;
+        A.no_states_=no_states_;
+        A.init_=init_;
+        A.no_inputs_=inputs.size();
+        A.post_.resize(abs_ptr_type(A.no_states_)*A.no_inputs_);
+        for (abs_type i=0; i<no_states_; i++) {
+            for (abs_type j=0; j<A.no_inputs_; j++) {
+                A.post_[A.addr(i,j)]=post_[addr(i,inputs[j])];
+            }
+        }
+        return A;
+    }
+    /*! Map an automaton over the classes of a partition of the inputs back to the original inputs: every input gets the transitions of its class (the inverse of restrictInputs to the class representatives).
+     * \param[in] input_class   vector containing the class of each original input */
+    void expandInputs(const std::vector<abs_type>& input_class) {
+        abs_type no_inputs_new=input_class.size();
+        std::vector<std::unordered_set<abs_type>> post_new(abs_ptr_type(no_states_)*no_inputs_new);
+        for (abs_type i=0; i<no_states_; i++) {
+            for (abs_type j=0; j<no_inputs_new; j++) {
+                post_new[abs_ptr_type(i)*no_inputs_new+j]=post_[addr(i,input_class[j])];
+            }
+        }
+        no_inputs_=no_inputs_new;
+        post_=std::move(post_new);
+    }
+    /*! Match the states of this automaton one-to-one with the states of another automaton over the same inputs (usually an older version of this one). Only states in the same class of the coarsest bisimulation over both automata are matched, and the reject states are matched with each other; within a class, the states are matched in increasing order.
+     * \param[in] other     the other automaton
+     * \param[out] match    vector[N] containing the matched state of other, or other.no_states_ if the state is not matched */
+    std::vector<abs_type> matchStates(const SafetyAutomaton& other) const {
+        std::vector<abs_type> match(no_states_,other.no_states_);
+        if (no_inputs_!=other.no_inputs_) {
+            return match;
+        }
+        /* the states of this automaton are followed by the states of other */
+        abs_type n=no_states_+other.no_states_;
+        auto post_of = [&](const abs_type i, const abs_type j) -> const std::unordered_set<abs_type>& {
+            return (i<no_states_ ? post_[addr(i,j)] : other.post_[other.addr(i-no_states_,j)]);
+        };
+        auto offset = [&](const abs_type i) -> abs_type {
+            return (i<no_states_ ? 0 : no_states_);
+        };
+        std::vector<abs_type> cls(n);
+        for (abs_type i=0; i<n; i++) {
+            cls[i]=(i-offset(i)==0 ? 0 : 1);
+        }
+        cls=classes_of_equal_keys(cls);
+        abs_type no_classes=class_representatives(cls).size();
+        while (1) {
+            std::vector<std::vector<abs_type>> keys(n);
+            for (abs_type i=0; i<n; i++) {
+                keys[i].push_back(cls[i]);
+                for (abs_type j=0; j<no_inputs_; j++) {
+                    std::vector<abs_type> p;
+                    for (auto i2=post_of(i,j).begin(); i2!=post_of(i,j).end(); ++i2) {
+                        p.push_back(cls[*i2+offset(i)]);
+                    }
+                    std::sort(p.begin(),p.end());
+                    p.erase(std::unique(p.begin(),p.end()),p.end());
+                    keys[i].push_back(p.size());
+                    keys[i].insert(keys[i].end(),p.begin(),p.end());
+                }
+            }
+            cls=classes_of_equal_keys(keys);
+            abs_type no_classes_new=class_representatives(cls).size();
+            if (no_classes_new==no_classes) {
+                break;
+            }
+            no_classes=no_classes_new;
+        }
+        /* pair up the states of both automata class by class; every state of other is handed out at most once, so the matching is injective (UpdateTransitions of Monitor relies on this) */
+        std::vector<std::vector<abs_type>> members(no_classes);
+        for (abs_type i=no_states_; i<n; i++) {
+            members[cls[i]].push_back(i-no_states_);
+        }
+        std::vector<size_t> used(no_classes,0);
+        for (abs_type i=0; i<no_states_; i++) {
+            if (used[cls[i]]<members[cls[i]].size()) {
+                match[i]=members[cls[i]][used[cls[i]]++];
+            }
+        }
+        return match;
+    }
     /*! Address of post in post array.
      * \param[in] i           state index
      * \param[in] j           input index
      * \param[out] ind    address of the post state vector in post **/
-    inline int addr(const abs_type i, const abs_type j) const {
-        return (i*no_inputs_ + j);
+    inline abs_ptr_type addr(const abs_type i, const abs_type j) const {
+        return (abs_ptr_type(i)*no_inputs_ + j);
     }
     /*! Save the description of the safety automaton as a directed graph
      * \param[in] filename    The name of the output file
@@ -433,14 +932,14 @@ public:
         *s="-";
         edge_labels.push_back(s);
         /* create a new post array with the universal disturbance input symbol */
-        std::unordered_set<abs_type>** post_new=new std::unordered_set<abs_type>*[no_states_*(no_inputs_+1)];
-        for (abs_type i=0; i<no_states_*(no_inputs_+1); i++) {
+        std::unordered_set<abs_type>** post_new=new std::unordered_set<abs_type>*[abs_ptr_type(no_states_)*(no_inputs_+1)];
+        for (abs_ptr_type i=0; i<abs_ptr_type(no_states_)*(no_inputs_+1); i++) {
             std::unordered_set<abs_type>* s=new std::unordered_set<abs_type>;
             post_new[i]=s;
         }
         /* the address of the post vector in the "transitions" array is determined using the following lambda expression */
-        auto post_addr = [&](abs_type x, abs_type w) -> abs_type {
-            return (x*(no_inputs_+1) + w);
+        auto post_addr = [&](abs_type x, abs_type w) -> abs_ptr_type {
+            return (abs_ptr_type(x)*(no_inputs_+1) + w);
         };
         /* the set of all states in one vector */
         std::unordered_set<abs_type> all_states;
@@ -452,7 +951,7 @@ public:
             /* check the universal successors for this control input */
             std::unordered_set<abs_type> univ_succ=all_states;
             for (abs_type k=0; k<no_inputs_; k++) {
-                univ_succ=setIntersect(univ_succ,*post_[addr(i,k)]);
+                univ_succ=setIntersect(univ_succ,post_[addr(i,k)]);
             }
             /* associate the universal successors with the special input with index no_inputs_ */
             for (auto i2=univ_succ.begin(); i2!=univ_succ.end(); ++i2) {
@@ -460,7 +959,7 @@ public:
             }
             /* next, add the non-universal successors */
             for (abs_type k=0; k<no_inputs_; k++) {
-                for (auto i2=post_[addr(i,k)]->begin(); i2!=post_[addr(i,k)]->end(); ++i2) {
+                for (auto i2=post_[addr(i,k)].begin(); i2!=post_[addr(i,k)].end(); ++i2) {
                     if (univ_succ.find(*i2)==univ_succ.end()) {
                         post_new[post_addr(i,k)]->insert(*i2);
                     }
@@ -478,6 +977,22 @@ public:
         createDiGraph<abs_type>(filename, graph_name, state_labels, init_, edge_labels, post_new);
     }
 private:
+    /*! Make this an empty automaton (used for the moved-from objects) */
+    void clear() {
+        no_states_=0;
+        no_inputs_=0;
+        init_.clear();
+        post_.clear();
+    }
+    /*! Pointers to the elements of post_ (for the file handling functions, which work with arrays of pointers to sets)
+     * \param[out] v     the vector of pointers */
+    std::vector<std::unordered_set<abs_type>*> postPointers() {
+        std::vector<std::unordered_set<abs_type>*> v;
+        for (size_t i=0; i<post_.size(); i++) {
+            v.push_back(&post_[i]);
+        }
+        return v;
+    }
     /*! Intersect two sets
      * \param[in] s1    The first set
      * \param[in] s2    The second set
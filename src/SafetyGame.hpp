@@ -9,6 +9,8 @@
 
 #include <cstring>
 
+#include "Attractor.hpp"
+
 
 /** @namespace negotiation **/
 namespace negotiation {
@@ -24,25 +26,47 @@ public:
     /*! Constructor
      * \param[in] comp    The component
      * \param[in] assume  A safety automaton representing the current assumptions
-     * \param[in] guarantee A safety automaton representing the current guarantees */
-    SafetyGame(Component& comp, SafetyAutomaton& assume, SafetyAutomaton& guarantee) : Monitor(comp, assume, guarantee) {}
+     * \param[in] guarantee A safety automaton representing the current guarantees
+     * \param[in] arena    [Optional] the arena to allocate from (a new one is created by default) */
+    SafetyGame(Component& comp, SafetyAutomaton& assume, SafetyAutomaton& guarantee, std::shared_ptr<Arena> arena=std::shared_ptr<Arena>()) : Monitor(comp, assume, guarantee, arena) {}
+    /*! Constructor: the transitions are stored in memory-mapped temporary files (see the corresponding constructor of Monitor)
+     * \param[in] comp            The component
+     * \param[in] assume          A safety automaton representing the current assumptions
+     * \param[in] guarantee       A safety automaton representing the current guarantees
+     * \param[in] dir             The directory of the temporary files
+     * \param[in] memory_budget   The resident memory used for building the pre array, in bytes
+     * \param[in] arena           [Optional] the arena to allocate from (a new one is created by default) */
+    SafetyGame(Component& comp, SafetyAutomaton& assume, SafetyAutomaton& guarantee, const std::string& dir, const size_t memory_budget, std::shared_ptr<Arena> arena=std::shared_ptr<Arena>()) : Monitor(comp, assume, guarantee, dir, memory_budget, arena) {}
+    /*! Constructor: incremental update of the safety game old after the assumption and the guarantee were refined (see the corresponding constructor of Monitor)
+     * \param[in] old             The safety game built for the same component and for old_assume and old_guarantee
+     * \param[in] old_assume      The assumption of old
+     * \param[in] old_guarantee   The guarantee of old
+     * \param[in] comp            The component
+     * \param[in] assume          A safety automaton representing the current assumptions
+     * \param[in] guarantee       A safety automaton representing the current guarantees
+     * \param[in] arena           [Optional] the arena to allocate from (a new one is created by default) */
+    SafetyGame(SafetyGame& old, SafetyAutomaton& old_assume, SafetyAutomaton& old_guarantee, Component& comp, SafetyAutomaton& assume, SafetyAutomaton& guarantee, std::shared_ptr<Arena> arena=std::shared_ptr<Arena>()) : Monitor(old, old_assume, old_guarantee, comp, assume, guarantee, arena) {}
     /*! Solve safety game.
      *  The algorithm is taken from: https://gitlab.lrz.de/matthias/SCOTSv0.2/raw/master/manual/manual.pdf
      *
      * The state reject_A (ind=0) is safe but reject_G (ind=1) is unsafe by default.
      *
+     * In the local mode, only the states reachable from the initial states are solved (the rest get an empty strategy, which does not affect find_spoilers). Moreover, the maybe game stops as soon as some initial state is found to be losing, as find_spoilers then fails anyway unless all the initial states are sure winning; the strategy is incomplete in this case.
+     *
      * \param[in] component_safe_states         indices of safe states
      * \param[in] str                                                 string specifying the sure/maybe winning condition
+     * \param[in] local                          [Optional] use the local mode (default: false)
      * \param[out] D                             winning (monitor) state-input pairs */
-    std::vector<std::unordered_set<abs_type>*> solve_safety_game(const std::unordered_set<abs_type> component_safe_states, const char* str="sure") {
+    std::vector<arena_set*> solve_safety_game(const std::unordered_set<abs_type> component_safe_states, const char* str="sure", const bool local=false) {
         /* sanity check */
-        if (!strcmp(str,"sure") && !strcmp(str,"maybe")) {
+        if (strcmp(str,"sure") && strcmp(str,"maybe")) {
             try {
                 throw std::runtime_error("Safety Game: invalid input.");
             } catch (std::exception& e) {
                 std::cout << e.what() << "\n";
             }
         }
+        bool sure=!strcmp(str,"sure");
         /* safe states */
         std::unordered_set<abs_type> monitor_safe_states;
         for (abs_type im=0; im<no_states; im++) {
@@ -54,80 +78,28 @@ public:
             }
         }
         /* avoid direct help by assumption violation in maybe mode */
-        if (!strcmp(str,"sure")) {
+        if (sure) {
             monitor_safe_states.insert(0); /* the state 0 is safe for sure winning */
         }
-        std::queue<abs_type> Q; /* FIFO queue of bad states */
-        std::unordered_set<abs_type> E; /* bad states */
-        std::vector<std::unordered_set<abs_type>*> D; /* set of valid inputs indexed by the monitor state indices */
-        for (abs_type i=0; i<no_states; i++) {
-            std::unordered_set<abs_type>* s = new std::unordered_set<abs_type>;
-            D.push_back(s);
-        }
-        /* initialize Q, E, D for all the states */
-        for (abs_type i=0; i<no_states; i++) {
-            if (!isMember<abs_type>(monitor_safe_states,i) || isDeadEnd(i)) {
-                Q.push(i);
-                E.insert(i);
-            } else {
-                if (!strcmp(str,"sure")) {
-                    /* for sure winning, D[i] initially contains all the inputs for which there is some successor */
-                    for (abs_type j=0; j<no_control_inputs; j++) {
-                        for (abs_type k=0; k<no_dist_inputs; k++) {
-                            if (no_post[addr_xuw(i,j,k)]!=0) {
-                                D[i]->insert(j);
-                                break;
-                            }
-                        }
-                    }
-                } else {
-                    /* for maybe winning, D[i] initially contains all the joint input indices for which there is some successor */
-                    for (abs_type j=0; j<no_control_inputs; j++) {
-                        for (abs_type k=0; k<no_dist_inputs; k++) {
-                            if (no_post[addr_xuw(i,j,k)]!=0) {
-                                D[i]->insert(addr_uw(j,k));
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        /* iterate until Q is empty, i.e. when a fixed point is reached*/
-        while (Q.size()!=0) {
-            abs_type x = Q.front();
-            Q.pop();
-            for (abs_type j=0; j<no_control_inputs; j++) {
-                for (abs_type k=0; k<no_dist_inputs; k++) {
-                    abs_type x2 = addr_xuw(x,j,k);
-                    for (auto it=pre[x2]->begin(); it!=pre[x2]->end(); ++it) {
-                        if (!strcmp(str,"sure")) {
-                            /* remove all the control inputs from the pre-states of x which lead to x */
-                            D[*it]->erase(j);
-                        } else {
-                            /* remove all the joint inputs from the pre-states of x which lead to x */
-                            D[*it]->erase(addr_uw(j,k));
-                        }
-                        if (D[*it]->size()==0 && !isMember<abs_type>(E,*it)) {
-                            /* debug */
-                            // std::cout << "state marked as bad = " << *it << "\n";
-                            /* debug end */
-                            Q.push(*it);
-                            E.insert(*it);
-                        }
-                    }
-                }
-            }
+        /* set of valid inputs indexed by the monitor state indices: the control inputs for sure winning, and the joint inputs for maybe winning */
+        std::vector<arena_set*> D=new_set_vector(no_states);
+        /* iterate until a fixed point of the bad states is reached */
+        if (sure) {
+            SafetyObjective<SureSemantics> objective(monitor_safe_states,D,local);
+            solve_attractor(*this,objective,no_threads_);
+        } else {
+            SafetyObjective<MaybeSemantics> objective(monitor_safe_states,D,local,local);
+            solve_attractor(*this,objective,no_threads_);
         }
-
         return D;
     }
     /*! Generate the spoiling behavior as a safety automaton and write to a file.
      * \param[in] sure_win    sure winning state-control input pairs
-     * \param[in] maybe_win maybe winning state-join input pairs
+     * \param[in] maybe_win maybe winning state-join input pairs (not accessed when all the initial states are sure winning)
      * \param[in] spoilers        the safety automaton storing the spoiling behaviors
      * \param[out] out_flag   0 -> some initial states are sure losing, 2 -> all initial states are sure winning, 1-> otherwise. For out_flag=0,2, spoilers is an automaton that accepts all strings.
      */
-    int find_spoilers(const std::vector<std::unordered_set<negotiation::abs_type>*>& sure_win, const std::vector<std::unordered_set<negotiation::abs_type>*>& maybe_win, negotiation::SafetyAutomaton* spoilers) {
+    int find_spoilers(const std::vector<arena_set*>& sure_win, const std::vector<arena_set*>& maybe_win, negotiation::SafetyAutomaton* spoilers) {
         /* the output flag */
         int out_flag;
         /* if all the initial states are sure winning, then the set of spoiling behaviors is empty */
@@ -161,7 +133,7 @@ public:
             return out_flag;
         }
         /* compute the set of reachable states */
-        std::unordered_set<abs_type> reachable_set = compute_reachable_set();
+        compute_reachable_bitset();
         /* map from old state indices to new state indices: all the losing states (i.e. not maybe winning) and the unreachable states are lumped in state 0 */
         std::vector<abs_type> new_state_ind;
         /* count new states */
@@ -174,7 +146,7 @@ public:
         no_new_states++;
         /* for the rest of the reachable maybe winning monitor states, a new state index is created, and all the losing monitor states are mapped to state 0 */
         for (abs_type i=2; i<no_states; i++) {
-            if (maybe_win[i]->size()!=0 && reachable_set.find(i)!=reachable_set.end()) {
+            if (maybe_win[i]->size()!=0 && is_reachable(i)) {
                 new_state_ind.push_back(no_new_states);
                 no_new_states++;
             } else {
@@ -187,58 +159,10 @@ public:
             spoilers->init_.insert(new_state_ind[*i]);
         }
         spoilers->no_inputs_=no_dist_inputs;
-        /* construct the post transition array of the original transition systems */
-        std::unordered_set<abs_type>** post_loc=new std::unordered_set<abs_type>*[no_states*no_control_inputs*no_dist_inputs];
-        for (abs_type i=0; i<no_states*no_control_inputs*no_dist_inputs; i++) {
-            std::unordered_set<abs_type>* v=new std::unordered_set<abs_type>;
-            post_loc[i]=v;
-        }
-        /* the induced sure win strategy are sure winning strategies (when they exist), or control inputs for which all disturbance inputs are in maybe winning strategy */
-        std::vector<std::unordered_set<abs_type>*> sure_win_induced;
-        for (abs_type i=0; i<no_states; i++) {
-            std::unordered_set<abs_type>* set = new std::unordered_set<abs_type>;
-            if (sure_win[i]->size()!=0) {
-                *set=*sure_win[i];
-            } else {
-                for (abs_type j=0; j<no_control_inputs; j++) {
-                    /* if for this control input all the disturbance inputs are in the maybe winning strategy, then this control input is an induced sure safe strategy */
-                    bool is_induced_sure_strategy=true;
-                    for (abs_type k=0; k<no_dist_inputs; k++) {
-                        if (maybe_win[i]->find(addr_uw(j,k))==maybe_win[i]->end()) {
-                            is_induced_sure_strategy=false;
-                            break;
-                        }
-                    }
-                    if (is_induced_sure_strategy) {
-                        set->insert(j);
-                    }
-                }
-            }
-            sure_win_induced.push_back(set);
-        }
-        /* first fill the post array by disregarding the control restriction imposed by sure_win and maybe_win */
-        /* 0 is the sink state */
-        for (abs_type j=0; j<no_control_inputs; j++) {
-            for (abs_type k=0; k<no_dist_inputs; k++) {
-                post_loc[addr_post(0,j,k)]->insert(0);
-            }
-        }
-        /* for the rest, use the pre */
-        for (abs_type i=1; i<no_states; i++) {
-            for (abs_type j=0; j<no_control_inputs; j++) {
-                for (abs_type k=0; k<no_dist_inputs; k++) {
-                    std::unordered_set<abs_type> p=*pre[addr_xuw(i,j,k)];
-                    for (auto l=p.begin(); l!=p.end(); ++l) {
-                        post_loc[addr_post(*l,j,k)]->insert(i);
-                    }
-                }
-            }
-        }
         /* next create a new array by disallowing transitions as per the restriction in sure_win and maybe_win, and abstracting away the control inputs */
-        std::unordered_set<abs_type>** arr2=new std::unordered_set<abs_type>*[no_new_states*no_dist_inputs];
-        for (abs_type i=0; i<no_new_states*no_dist_inputs; i++) {
-            std::unordered_set<abs_type>* v=new std::unordered_set<abs_type>;
-            arr2[i]=v;
+        arena_set** arr2=new_set_array(abs_ptr_type(no_new_states)*no_dist_inputs);
+        for (abs_ptr_type i=0; i<abs_ptr_type(no_new_states)*no_dist_inputs; i++) {
+            arr2[i]=new_set();
         }
         /* first add self loops to the reject state */
         for (abs_type k=0; k<no_dist_inputs; k++) {
@@ -251,21 +175,37 @@ public:
         for (abs_type q=2; q<no_states; q++) {
             /* the current state i is set as the q-th state in the domain of the reachable part of maybe_win */
             abs_type i;
-            if (maybe_win[q]->size()!=0 && reachable_set.find(q)!=reachable_set.end()) {
+            if (maybe_win[q]->size()!=0 && is_reachable(q)) {
                 i=q;
             } else {
                 continue;
             }
+            /* the induced sure winning strategy: the sure winning strategy (when it exists), or the control inputs for which all disturbance inputs are in the maybe winning strategy */
+            std::vector<abs_type> sure_win_induced;
+            if (sure_win[i]->size()!=0) {
+                sure_win_induced.assign(sure_win[i]->begin(),sure_win[i]->end());
+            } else {
+                for (abs_type j=0; j<no_control_inputs; j++) {
+                    bool is_induced_sure_strategy=true;
+                    for (abs_type k=0; k<no_dist_inputs; k++) {
+                        if (maybe_win[i]->find(addr_uw(j,k))==maybe_win[i]->end()) {
+                            is_induced_sure_strategy=false;
+                            break;
+                        }
+                    }
+                    if (is_induced_sure_strategy) {
+                        sure_win_induced.push_back(j);
+                    }
+                }
+            }
             /* if the state i is sure winning: no outgoing transition to reject state, and only outgoing transitions conforming to the strategy */
-            if (sure_win_induced[i]->size()!=0) {
+            if (sure_win_induced.size()!=0) {
                 /* iterate over all the winning strategies */
-                for (auto it=sure_win_induced[i]->begin(); it!=sure_win_induced[i]->end(); ++it) {
+                for (auto it=sure_win_induced.begin(); it!=sure_win_induced.end(); ++it) {
                     /* iterate over all the disturbance inputs*/
                     for (abs_type k=0; k<no_dist_inputs; k++) {
                         /* iterate over all the post states */
-                        for (auto it2=post_loc[addr_post(i,*it,k)]->begin(); it2!=post_loc[addr_post(i,*it,k)]->end(); it2++) {
-                            arr2[addr(ind,k)]->insert(new_state_ind[*it2]);
-                        }
+                        add_posts(i,*it,k,arr2[addr(ind,k)],new_state_ind);
                     }
                 }
                 ind++;
@@ -290,9 +230,7 @@ public:
                     for (abs_type k=0; k<no_dist_inputs; k++) {
                         if (maybe_win[i]->find(addr_uw(j,k)) != maybe_win[i]->end()) {
                             /* iterate over all the post states */
-                            for (auto it2=post_loc[addr_post(i,j,k)]->begin(); it2!=post_loc[addr_post(i,j,k)]->end(); it2++) {
-                                arr2[addr(ind,k)]->insert(new_state_ind[*it2]);
-                            }
+                            add_posts(i,j,k,arr2[addr(ind,k)],new_state_ind);
                         } else {
                             /* if the joint action is not in the maybe winning strategy: transition to reject (ind 0) state */
                             arr2[addr(ind,k)]->insert(0);
@@ -303,8 +241,6 @@ public:
             }
         }
         spoilers->addPost(arr2);
-        delete[] post_loc;
-        delete[] arr2;
 
         /* successfully generated a spoiling automaton: return out_flag=1 */
         out_flag=1;
@@ -315,16 +251,24 @@ private:
      * \param[in] i           state index
      * \param[in] k           disturbance input index
      * \param[out] ind    address of the post state vector in post **/
-    inline abs_type addr(const abs_type i, const abs_type k) {
-        return (i*no_dist_inputs + k);
+    inline abs_ptr_type addr(const abs_type i, const abs_type k) {
+        return (abs_ptr_type(i)*no_dist_inputs + k);
     }
-    /*! Address of pre in post array.
-     * \param[in] i           state index
-     * \param[in] j           control input index
-     * \param[in] k           disturbance input index
-     * \param[out] ind    address of the post state vector in post **/
-    inline abs_type addr_post(const abs_type i, const abs_type j, const abs_type k) {
-        return (i*no_control_inputs*no_dist_inputs + j*no_dist_inputs + k);
+    /*! Add the new indices of the posts of an enabled state-input triple to a transition of the spoilers (the transitions to the monitor state 0 are left out; a disabled triple has no posts).
+     * \param[in] i               state index
+     * \param[in] j               control input index
+     * \param[in] k               disturbance input index
+     * \param[in] set             the posts of the transition of the spoilers
+     * \param[in] new_state_ind   map from the monitor states to the states of the spoilers */
+    inline void add_posts(const abs_type i, const abs_type j, const abs_type k, arena_set* set, const std::vector<abs_type>& new_state_ind) {
+        if (!enabled_[addr_xuw(i,j,k)]) {
+            return;
+        }
+        for_each_post(addr_xuw(i,j,k),[&](const abs_type i2) {
+            if (i2!=0) {
+                set->insert(new_state_ind[i2]);
+            }
+        });
     }
     /*! Index of the disturbance input from a joint control-disturbance index.
      * \param[in] l             joint control-disturbance input index
@@ -332,18 +276,6 @@ private:
     inline abs_type dist_ind(const abs_type l) {
         return (l % no_dist_inputs);
     }
-    /*! Check if a given monitor state is a dead-end.
-     * \param[in] i     state index*/
-    bool isDeadEnd(const abs_type i) {
-        for (abs_type j=0; j<no_control_inputs; j++) {
-            for (abs_type k=0; k<no_dist_inputs; k++) {
-                if (no_post[addr_xuw(i,j,k)]!=0) {
-                    return false;
-                }
-            }
-        }
-        return true;
-    }
 
 };/* end of class definition */
 }/* end of namespace */
@@ -0,0 +1,133 @@
+/* SpoilerCache.hpp
+ *
+ *  Date: 19/10/2026 */
+
+/** @file **/
+#ifndef SPOILERCACHE_HPP_
+#define SPOILERCACHE_HPP_
+
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+
+#include "SafetyAutomaton.hpp"
+
+/** @namespace negotiation **/
+namespace negotiation {
+
+/**
+ *  @class SpoilerCache
+ *
+ *  @brief Memoization of the spoiling behaviors computed for a given component and a given pair of assumption and guarantee.
+ *
+ *  The outcome of Negotiate::compute_spoilers_overall only depends on the component (which never changes) and on the current guarantees of both the components. The entries are keyed by the component index and the canonical encodings (see SafetyAutomaton::canonicalEncoding) of the two guarantees, so that a lookup succeeds whenever the same pair of guarantees (up to renumbering of their states) shows up again, be it at a different depth or in a later round. The cache can be shared by several concurrent negotiations.
+ */
+class SpoilerCache {
+private:
+    /** @brief a cached entry **/
+    struct Entry {
+        /** @brief the component index followed by the canonical encodings of its own guarantee and of its assumption **/
+        std::vector<abs_type> key_;
+        /** @brief the spoiling behaviors **/
+        SafetyAutomaton spoilers_;
+        /** @brief the output flag of compute_spoilers_overall **/
+        int flag_;
+    };
+    /** @brief the entries, bucketed by the hash of their key **/
+    std::unordered_map<std::size_t, std::vector<Entry*>> entries_;
+    /** @brief guards entries_ **/
+    std::mutex mutex_;
+public:
+    /*! Destructor */
+    ~SpoilerCache() {
+        clear();
+    }
+    /*! Look up the spoiling behaviors for a given component.
+     * \param[in] c               the component index
+     * \param[in] guarantee      the guarantee of component c
+     * \param[in] assume          the assumption of component c (i.e. the guarantee of the other component)
+     * \param[in] spoilers      the safety automaton where the cached spoiling behaviors are copied to
+     * \param[in] flag             the cached output flag
+     * \param[out] hit             true if an entry was found, false otherwise */
+    bool lookup(const int c, const SafetyAutomaton& guarantee, const SafetyAutomaton& assume, SafetyAutomaton* spoilers, int& flag) {
+        std::vector<abs_type> key=makeKey(c,guarantee,assume);
+        std::size_t h=hashKey(key);
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it=entries_.find(h);
+        if (it==entries_.end()) {
+            return false;
+        }
+        for (size_t i=0; i<it->second.size(); i++) {
+            if (it->second[i]->key_==key) {
+                *spoilers=it->second[i]->spoilers_;
+                flag=it->second[i]->flag_;
+                return true;
+            }
+        }
+        return false;
+    }
+    /*! Store the spoiling behaviors for a given component.
+     * \param[in] c               the component index
+     * \param[in] guarantee      the guarantee of component c
+     * \param[in] assume          the assumption of component c (i.e. the guarantee of the other component)
+     * \param[in] spoilers      the spoiling behaviors
+     * \param[in] flag             the output flag of compute_spoilers_overall */
+    void insert(const int c, const SafetyAutomaton& guarantee, const SafetyAutomaton& assume, const SafetyAutomaton& spoilers, const int flag) {
+        Entry* e=new Entry;
+        e->key_=makeKey(c,guarantee,assume);
+        e->spoilers_=spoilers;
+        e->flag_=flag;
+        std::size_t h=hashKey(e->key_);
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<Entry*>& bucket=entries_[h];
+        for (size_t i=0; i<bucket.size(); i++) {
+            if (bucket[i]->key_==e->key_) {
+                /* some concurrent negotiation was faster */
+                delete e;
+                return;
+            }
+        }
+        bucket.push_back(e);
+    }
+    /*! Number of cached entries */
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t n=0;
+        for (auto it=entries_.begin(); it!=entries_.end(); ++it) {
+            n+=it->second.size();
+        }
+        return n;
+    }
+    /*! Remove all the entries */
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it=entries_.begin(); it!=entries_.end(); ++it) {
+            for (size_t i=0; i<it->second.size(); i++) {
+                delete it->second[i];
+            }
+        }
+        entries_.clear();
+    }
+private:
+    /*! The key of an entry: the component index followed by the canonical encodings of the two automata (every encoding starts with the sizes, so the concatenation is unambiguous) */
+    std::vector<abs_type> makeKey(const int c, const SafetyAutomaton& guarantee, const SafetyAutomaton& assume) {
+        std::vector<abs_type> key;
+        key.push_back(c);
+        std::vector<abs_type> enc=guarantee.canonicalEncoding();
+        key.insert(key.end(),enc.begin(),enc.end());
+        enc=assume.canonicalEncoding();
+        key.insert(key.end(),enc.begin(),enc.end());
+        return key;
+    }
+    /*! FNV-1a hash of a key */
+    std::size_t hashKey(const std::vector<abs_type>& key) {
+        std::uint64_t h=14695981039346656037ULL;
+        for (size_t i=0; i<key.size(); i++) {
+            h^=key[i];
+            h*=1099511628211ULL;
+        }
+        return static_cast<std::size_t>(h);
+    }
+};/* end of class definition */
+}/* end of namespace negotiation */
+#endif
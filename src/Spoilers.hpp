@@ -37,10 +37,33 @@ public:
     /*! Constructor
      * \param[in] full  The original safety automaton that is to be minimized (see our EMSOFT 2020 paper for the minimization heuristic)*/
     Spoilers(SafetyAutomaton* full) {
+        /* the full safety automaton is a copy of the argument */
+        spoilers_full_= new negotiation::SafetyAutomaton(*full);
+        initialize();
+    }
+    /*! Constructor
+     * \param[in] full  The original safety automaton that is to be minimized, which is moved into spoilers_full_ (and left empty) */
+    Spoilers(SafetyAutomaton&& full) {
+        spoilers_full_= new negotiation::SafetyAutomaton(std::move(full));
+        initialize();
+    }
+    Spoilers(const Spoilers&)=delete;
+    Spoilers& operator=(const Spoilers&)=delete;
+    /*! Destructor */
+    ~Spoilers() {
+        delete spoilers_full_;
+        delete spoilers_mini_;
+        for (size_t i=0; i<quotient_.size(); i++) {
+            delete quotient_[i];
+        }
+        for (size_t i=0; i<inv_quotient_.size(); i++) {
+            delete inv_quotient_[i];
+        }
+    }
+    /*! Initialize the minimized automaton and the quotient from spoilers_full_ (used by the constructors) */
+    void initialize() {
         /* initially the minimization level is 0 */
         k_=0;
-        /* the full safety automaton is given by the argument */
-        spoilers_full_= new negotiation::SafetyAutomaton(*full);
         /* the minimized automaton is initialized by clustering all the non-rejecting concrete states into one abstract state and the reject state (index 0) to another */
         spoilers_mini_= new negotiation::SafetyAutomaton();
         spoilers_mini_->no_states_=2;
@@ -73,11 +96,7 @@ public:
         abs_type ns=spoilers_mini_->no_states_;
         abs_type ni=spoilers_mini_->no_inputs_;
         /* the vector post is used to build the post_ of spoilers_mini_ */
-        std::unordered_set<abs_type>** post = new std::unordered_set<abs_type>*[ns*ni];
-        for (abs_type i=0; i<ns*ni; i++) {
-            std::unordered_set<abs_type>* v=new std::unordered_set<abs_type>;
-            post[i]=v;
-        }
+        std::vector<std::unordered_set<abs_type>> post(checked_product({ns,ni},std::numeric_limits<size_t>::max()/sizeof(std::unordered_set<abs_type>),"Spoilers: the number of state-input pairs of the minimized automaton"));
         /* add transitions to post: j-transitions (j is input) are added between two abstract states qi and ql when there exist j-transitions between some concrete state in qi to some concrete state in ql */
         /* iterate over all the pre concrete states */
         for (abs_type i=0; i<spoilers_full_->no_states_; i++) {
@@ -86,10 +105,10 @@ public:
                 /* iterate over all the inputs */
                 for (abs_type j=0; j<spoilers_full_->no_inputs_; j++) {
                     /* iterate over all the concrete post states */
-                    for (auto it=spoilers_full_->post_[spoilers_full_->addr(i,j)]->begin(); it!=spoilers_full_->post_[spoilers_full_->addr(i,j)]->end(); ++it) {
+                    for (auto it=spoilers_full_->post_[spoilers_full_->addr(i,j)].begin(); it!=spoilers_full_->post_[spoilers_full_->addr(i,j)].end(); ++it) {
                         /* iterate over all the inverse quotients of the concrete post state */
                         for (auto ql=inv_quotient_[*it]->begin(); ql!=inv_quotient_[*it]->end(); ++ql) {
-                            post[spoilers_mini_->addr(*qi,j)]->insert(*ql);
+                            post[spoilers_mini_->addr(*qi,j)].insert(*ql);
                         }
                     }
                 }
@@ -97,8 +116,7 @@ public:
 
         }
         /* reset transitions of spoilers_mini_ */
-        spoilers_mini_->addPost(post);
-        delete[] post;
+        spoilers_mini_->addPost(std::move(post));
     }
     /*! Overlapping (S1) and non-overlapping (S2) part of existential predecessor (using the full transition relation) of the minimized state r2 with the minimized state r1
      * \param[in] r1        current abstract state index (group of concrete states)
@@ -110,7 +128,7 @@ public:
         S2.clear();
         for (abs_type j=0; j<spoilers_mini_->no_inputs_; j++) {
             for (std::unordered_set<abs_type>::iterator i=quotient_[r1]->begin(); i!=quotient_[r1]->end(); ++i) {
-                for (auto k=spoilers_full_->post_[spoilers_full_->addr(*i,j)]->begin(); k!=spoilers_full_->post_[spoilers_full_->addr(*i,j)]->end(); ++k) {
+                for (auto k=spoilers_full_->post_[spoilers_full_->addr(*i,j)].begin(); k!=spoilers_full_->post_[spoilers_full_->addr(*i,j)].end(); ++k) {
                     if (quotient_[r2]->find(*k)!=quotient_[r2]->end()) {
                         S1.insert(*i);
                     }
@@ -150,6 +168,7 @@ public:
         std::unordered_set<abs_type>* last_quotient_old=new std::unordered_set<abs_type>;
         *last_quotient_old=*quotient_[quotient_.size()-1];
         /* remove the last quotient element */
+        delete quotient_.back();
         quotient_.pop_back();
         /* all the newly exposed concrete states get one unique quotient each */
         abs_type ia=quotient_.size(); /* the new quotient index of the first exposed state to be pulled in the following loop */
@@ -0,0 +1,74 @@
+/* SymbolicLivenessGame.hpp
+ *
+ *  Date: 19/10/2026 */
+
+/** @file **/
+#ifndef SYMBOLICLIVENESSGAME_HPP_
+#define SYMBOLICLIVENESSGAME_HPP_
+
+#include <cstring>
+#include <unordered_set>
+
+#include "SymbolicMonitor.hpp"
+
+/** @namespace negotiation **/
+namespace negotiation {
+/**
+ *  @class SymbolicLivenessGame
+ *
+ *  @brief The Buchi games of LivenessGame solved on a SymbolicMonitor.
+ */
+class SymbolicLivenessGame: public SymbolicMonitor {
+public:
+    /** @brief the target states: reject_A and the states whose component state is a target **/
+    Bdd target_;
+public:
+    /*! Constructor: the transitions of other are restricted to the allowed inputs as in the corresponding constructor of LivenessGame
+     *
+     * \param[in] other                     another symbolic monitor
+     * \param[in] component_target_states   set of component target states
+     * \param[in] allowed_control_inputs    allowed state-control input pairs over (x,u); the states without any allowed control input are not restricted by them
+     * \param[in] allowed_joint_inputs      allowed state-joint input pairs over (x,u,w) */
+    SymbolicLivenessGame(const SymbolicMonitor& other,
+                         const std::unordered_set<abs_type>& component_target_states,
+                         const Bdd& allowed_control_inputs,
+                         const Bdd& allowed_joint_inputs) : SymbolicMonitor(other) {
+        Bdd allowed=allowed_joint_inputs & (allowed_control_inputs | !allowed_control_inputs.exists(control_cube_));
+        /* the reject states are not restricted */
+        trans_&=((!real_) | allowed);
+        target_=reject_A_ | component_states(component_target_states);
+    }
+    /*! Solve Buchi game with additional safety objective (reject_G is to be avoided), with the semantics of LivenessGame::solve_liveness_game.
+     *
+     * The outer greatest fixed point Y shrinks to the states from where the targets which can stay in Y for one step can be reached while avoiding reject_G (inner least fixed point).
+     * \param[in] str                   string specifying the sure/maybe winning condition
+     * \param[in] assumption_violation  [Optional] whether reject_A is a target (default: true)
+     * \param[out] Y                    the winning states */
+    Bdd solve_liveness_game(const char* str="sure", const bool assumption_violation=true) {
+        if (strcmp(str,"sure") && strcmp(str,"maybe")) {
+            throw std::runtime_error("SymbolicLivenessGame: invalid input.");
+        }
+        bool sure=!strcmp(str,"sure");
+        Bdd target=(assumption_violation ? target_ : target_ & !reject_A_);
+        Bdd Y=manager_->one();
+        while (true) {
+            Bdd safe_targets=target & Y & cpre(Y,sure);
+            Bdd X=safe_targets;
+            while (true) {
+                Bdd X_new=safe_targets | ((!reject_G_) & cpre(X,sure));
+                if (X_new==X) {
+                    break;
+                }
+                X=X_new;
+            }
+            Bdd Y_new=X & Y;
+            if (Y_new==Y) {
+                break;
+            }
+            Y=Y_new;
+        }
+        return Y;
+    }
+};/* end of class definition */
+}/* end of namespace negotiation */
+#endif
@@ -0,0 +1,263 @@
+/* SymbolicMonitor.hpp
+ *
+ *  Date: 19/10/2026 */
+
+/** @file **/
+#ifndef SYMBOLICMONITOR_HPP_
+#define SYMBOLICMONITOR_HPP_
+
+#include <vector>
+#include <unordered_set>
+#include <memory>
+#include <climits>
+
+#include "Component.hpp" /* for the definition of data types abs_type and abs_ptr_type */
+#include "SafetyAutomaton.hpp"
+#include "Bdd.hpp"
+
+/** @namespace negotiation **/
+namespace negotiation {
+/**
+ *  @class SymbolicMonitor
+ *
+ * @brief The product of the component with the assume-guarantee pair (see Monitor), with the states, the inputs, and the transitions represented by BDDs.
+ *
+ * The component states, the assumption states, the guarantee states, the control inputs, and the disturbance inputs are encoded in binary, and a monitor state is the tuple (ic,ia,ig) of the codes of its parts. The monitor states other than the reject states have ia>0 and ig>0, the state reject_A (state 0 of Monitor) is encoded as (0,0,0), and the state reject_G (state 1 of Monitor) as (0,0,1). The transition relation is a BDD over the current state bits x, the control input bits u, the disturbance input bits w, and the next state bits x'; it has the same transitions as the ones of Monitor (see Monitor::addTransitions).
+ *
+ * The bits of the next states are interleaved with the bits of the current states, and the variables are reordered by the BDD manager when the diagrams grow. Copies of a symbolic monitor share the BDD manager.
+**/
+class SymbolicMonitor {
+public:
+    /** @brief the BDD manager **/
+    std::shared_ptr<BddManager> manager_;
+    /** @brief the variables of the bits (least significant bit first) of the current and the next component, assumption, and guarantee states, of the control and the disturbance inputs, and of the outputs of the component **/
+    std::vector<abs_type> comp_vars_, comp_vars_post_, assume_vars_, assume_vars_post_, guarantee_vars_, guarantee_vars_post_, control_vars_, dist_vars_, output_vars_;
+    /** @brief the renaming of the current state variables to the next state variables and the other way round **/
+    std::vector<abs_type> to_post_, to_pre_;
+    /** @brief the cubes of the next state variables, of the control inputs, of the disturbance inputs, and of the outputs **/
+    Bdd post_cube_, control_cube_, dist_cube_, output_cube_;
+    /** @brief the transition relation over (x,u,w,x') **/
+    Bdd trans_;
+    /** @brief the initial states **/
+    Bdd init_;
+    /** @brief the monitor states other than the reject states **/
+    Bdd real_;
+    /** @brief the reject states **/
+    Bdd reject_A_, reject_G_;
+    /** @brief number of component states, assume automaton states, guarantee automaton states, control inputs, and disturbance inputs **/
+    abs_type no_comp_states, no_assume_states, no_guarantee_states, no_control_inputs, no_dist_inputs;
+public:
+    /*! Copy constructor: the BDD manager is shared */
+    SymbolicMonitor(const SymbolicMonitor& other)=default;
+    /*! Constructor
+     * \param[in] comp          the component
+     * \param[in] assume        the assumption safety automaton
+     * \param[in] guarantee     the guarantee safety automaton */
+    SymbolicMonitor(Component& comp, SafetyAutomaton& assume, SafetyAutomaton& guarantee) {
+        if (comp.no_dist_inputs != assume.no_inputs_) {
+            throw std::runtime_error("SymbolicMonitor: assumption automaton's input alphabet size does not match with the component's disturbance input alphabet's size.");
+        }
+        if (comp.no_outputs != guarantee.no_inputs_) {
+            throw std::runtime_error("SymbolicMonitor: guarantee automaton's input alphabet size does not match with the component's output alphabet's size.");
+        }
+        no_comp_states=comp.no_states;
+        no_assume_states=assume.no_states_;
+        no_guarantee_states=guarantee.no_states_;
+        no_control_inputs=comp.no_control_inputs;
+        no_dist_inputs=comp.no_dist_inputs;
+        /* the variables: the inputs on top, then the current and the next state bits interleaved (most significant bit first), and the output bits at the bottom */
+        abs_type no_vars=0;
+        auto allocate = [&](const abs_type n, std::vector<abs_type>& vars) {
+            vars.assign(no_bits(n),0);
+            for (size_t b=vars.size(); b-->0; ) {
+                vars[b]=no_vars++;
+            }
+        };
+        auto allocate_interleaved = [&](const abs_type n, std::vector<abs_type>& vars, std::vector<abs_type>& vars_post) {
+            vars.assign(no_bits(n),0);
+            vars_post.assign(no_bits(n),0);
+            for (size_t b=vars.size(); b-->0; ) {
+                vars[b]=no_vars++;
+                vars_post[b]=no_vars++;
+            }
+        };
+        allocate(no_control_inputs,control_vars_);
+        allocate(no_dist_inputs,dist_vars_);
+        allocate_interleaved(no_comp_states,comp_vars_,comp_vars_post_);
+        allocate_interleaved(no_assume_states,assume_vars_,assume_vars_post_);
+        allocate_interleaved(no_guarantee_states,guarantee_vars_,guarantee_vars_post_);
+        allocate(comp.no_outputs,output_vars_);
+        manager_=std::make_shared<BddManager>(no_vars);
+        BddManager& m=*manager_;
+        for (abs_type v=0; v<no_vars; v++) {
+            to_post_.push_back(v);
+            to_pre_.push_back(v);
+        }
+        std::vector<abs_type> post_vars;
+        for (auto p : {std::make_pair(&comp_vars_,&comp_vars_post_), std::make_pair(&assume_vars_,&assume_vars_post_), std::make_pair(&guarantee_vars_,&guarantee_vars_post_)}) {
+            for (size_t b=0; b<p.first->size(); b++) {
+                to_post_[(*p.first)[b]]=(*p.second)[b];
+                to_pre_[(*p.second)[b]]=(*p.first)[b];
+                post_vars.push_back((*p.second)[b]);
+            }
+        }
+        post_cube_=m.cube(post_vars);
+        control_cube_=m.cube(control_vars_);
+        dist_cube_=m.cube(dist_vars_);
+        output_cube_=m.cube(output_vars_);
+        /* the valid codes of the inputs */
+        Bdd inputs=less_than(control_vars_,no_control_inputs) & less_than(dist_vars_,no_dist_inputs);
+        /* the monitor states */
+        real_=less_than(comp_vars_,no_comp_states) & !m.encode(assume_vars_,0) & less_than(assume_vars_,no_assume_states) & !m.encode(guarantee_vars_,0) & less_than(guarantee_vars_,no_guarantee_states);
+        reject_A_=m.encode(comp_vars_,0) & m.encode(assume_vars_,0) & m.encode(guarantee_vars_,0);
+        reject_G_=m.encode(comp_vars_,0) & m.encode(assume_vars_,0) & m.encode(guarantee_vars_,1);
+        /* the transitions of the component over (ic,u,w,ic'), and its outputs over (ic',o) */
+        std::vector<Bdd> terms;
+        for (abs_type ic=0; ic<comp.no_states; ic++) {
+            for (abs_type j=0; j<comp.no_control_inputs; j++) {
+                for (abs_type k=0; k<comp.no_dist_inputs; k++) {
+                    const std::vector<abs_type>& p=*comp.post[comp.addr(ic,j,k)];
+                    if (p.size()==0) {
+                        continue;
+                    }
+                    Bdd posts=m.zero();
+                    for (size_t n=0; n<p.size(); n++) {
+                        posts|=m.encode(comp_vars_post_,p[n]);
+                    }
+                    terms.push_back(m.encode(comp_vars_,ic) & m.encode(control_vars_,j) & m.encode(dist_vars_,k) & posts);
+                }
+            }
+        }
+        Bdd comp_trans=disjunction(terms);
+        for (abs_type ic=0; ic<comp.no_states; ic++) {
+            terms.push_back(m.encode(comp_vars_post_,ic) & m.encode(output_vars_,comp.state_to_output[ic]));
+        }
+        Bdd comp_output=disjunction(terms);
+        /* the transitions of the assumption over (ia,w,ia'), and of the guarantee over (ig,o,ig') */
+        Bdd assume_trans=automaton_transitions(assume,assume_vars_,dist_vars_,assume_vars_post_);
+        Bdd guarantee_trans=automaton_transitions(guarantee,guarantee_vars_,output_vars_,guarantee_vars_post_);
+        /* the assumption is rejecting when it has a rejecting successor, and the guarantee likewise for the output of the next component state */
+        Bdd assume_reject=(assume_trans & m.encode(assume_vars_post_,0)).exists(post_cube_);
+        Bdd assume_defined=assume_trans.exists(post_cube_);
+        Bdd guarantee_reject=comp_output.and_exists(guarantee_trans & m.encode(guarantee_vars_post_,0),output_cube_ & m.cube(guarantee_vars_post_));
+        Bdd guarantee_defined=comp_output.and_exists(guarantee_trans,output_cube_ & m.cube(guarantee_vars_post_));
+        Bdd guarantee_next=comp_output.and_exists(guarantee_trans,output_cube_);
+        Bdd comp_cube_post=m.cube(comp_vars_post_);
+        /* see Monitor::addTransitions: a rejecting assumption leads to reject_A for every component successor for which the guarantee is defined, otherwise a rejecting guarantee leads to reject_G, and otherwise the successors are the products of the successors */
+        Bdd to_reject_A=real_ & assume_reject & comp_trans.and_exists(guarantee_defined,comp_cube_post) & reject_A_.permute(to_post_);
+        Bdd to_reject_G=real_ & assume_defined & !assume_reject & comp_trans.and_exists(guarantee_defined & guarantee_reject,comp_cube_post) & reject_G_.permute(to_post_);
+        Bdd to_real=real_ & !assume_reject & assume_trans & comp_trans & !guarantee_reject & guarantee_next;
+        Bdd sink_loops=((reject_A_ & reject_A_.permute(to_post_)) | (reject_G_ & reject_G_.permute(to_post_)));
+        trans_=((to_reject_A | to_reject_G | to_real) | sink_loops) & inputs;
+        /* the initial states (see Monitor::initialize) */
+        init_=m.zero();
+        for (auto i=comp.init_.begin(); i!=comp.init_.end(); ++i) {
+            abs_type o=comp.state_to_output[*i];
+            for (auto k=guarantee.init_.begin(); k!=guarantee.init_.end(); ++k) {
+                const std::unordered_set<abs_type>* p = &guarantee.post_[guarantee.addr(*k,o)];
+                for (auto k2=p->begin(); k2!=p->end(); ++k2) {
+                    for (auto j=assume.init_.begin(); j!=assume.init_.end(); ++j) {
+                        init_|=state(*i,*j,*k2);
+                    }
+                }
+            }
+        }
+    }
+    /*! The monitor state (ic,ia,ig) over the current state variables */
+    Bdd state(const abs_type ic, const abs_type ia, const abs_type ig) {
+        BddManager& m=*manager_;
+        return m.encode(comp_vars_,ic) & m.encode(assume_vars_,ia) & m.encode(guarantee_vars_,ig);
+    }
+    /*! The monitor states other than the reject states whose component state is in the given set */
+    Bdd component_states(const std::unordered_set<abs_type>& component_states) {
+        std::vector<Bdd> terms;
+        for (auto i=component_states.begin(); i!=component_states.end(); ++i) {
+            terms.push_back(manager_->encode(comp_vars_,*i));
+        }
+        return real_ & disjunction(terms);
+    }
+    /*! The state-input pairs whose posts all lie in X, for the control inputs (sure semantics: over (x,u), for all the disturbance inputs) or the joint inputs (maybe semantics: over (x,u,w)); only the inputs with some post count
+     * \param[in] X         the set of states
+     * \param[in] sure      the semantics */
+    Bdd safe_inputs(const Bdd& X, const bool sure) {
+        Bdd quantified=(sure ? post_cube_ & dist_cube_ : post_cube_);
+        Bdd enabled=trans_.exists(quantified);
+        Bdd unsafe=trans_.and_exists(!X.permute(to_post_),quantified);
+        return enabled & !unsafe;
+    }
+    /*! The controllable predecessor of X: the states with some input whose posts all lie in X (see safe_inputs) */
+    Bdd cpre(const Bdd& X, const bool sure) {
+        return safe_inputs(X,sure).exists(sure ? control_cube_ : control_cube_ & dist_cube_);
+    }
+    /*! Whether all the initial states are in X */
+    bool contains_init(const Bdd& X) const {
+        return (init_ & !X).is_zero();
+    }
+protected:
+    /*! The number of bits needed to encode the numbers 0,...,n-1 (at least one) */
+    static abs_type no_bits(const abs_type n) {
+        abs_type b=1;
+        while (b<32 && (std::uint64_t(1)<<b)<n) {
+            b++;
+        }
+        return b;
+    }
+    /*! The codes over vars which are smaller than n */
+    Bdd less_than(const std::vector<abs_type>& vars, const abs_type n) {
+        BddManager& m=*manager_;
+        if ((std::uint64_t(1)<<vars.size())<=n) {
+            return m.one();
+        }
+        /* from the least significant bit upwards: the code is smaller than n on the bits seen so far */
+        Bdd lt=m.zero();
+        for (size_t b=0; b<vars.size(); b++) {
+            if ((n>>b) & 1) {
+                lt=m.nvar(vars[b]) | lt;
+            } else {
+                lt=m.nvar(vars[b]) & lt;
+            }
+        }
+        return lt;
+    }
+    /*! The disjunction of the terms, computed as a balanced tree (the terms are cleared) */
+    Bdd disjunction(std::vector<Bdd>& terms) {
+        if (terms.size()==0) {
+            return manager_->zero();
+        }
+        while (terms.size()>1) {
+            size_t n2=0;
+            for (size_t n=0; n<terms.size(); n+=2) {
+                terms[n2++]=(n+1<terms.size() ? terms[n] | terms[n+1] : terms[n]);
+            }
+            terms.resize(n2);
+        }
+        Bdd result=terms[0];
+        terms.clear();
+        return result;
+    }
+    /*! The transitions of a safety automaton over (state,input,post state)
+     * \param[in] A             the safety automaton
+     * \param[in] vars          the variables of the states
+     * \param[in] input_vars    the variables of the inputs
+     * \param[in] vars_post     the variables of the post states */
+    Bdd automaton_transitions(SafetyAutomaton& A, const std::vector<abs_type>& vars, const std::vector<abs_type>& input_vars, const std::vector<abs_type>& vars_post) {
+        BddManager& m=*manager_;
+        std::vector<Bdd> terms;
+        for (abs_type i=0; i<A.no_states_; i++) {
+            for (abs_type x=0; x<A.no_inputs_; x++) {
+                const std::unordered_set<abs_type>& p=A.post_[A.addr(i,x)];
+                if (p.size()==0) {
+                    continue;
+                }
+                Bdd posts=m.zero();
+                for (auto i2=p.begin(); i2!=p.end(); ++i2) {
+                    posts|=m.encode(vars_post,*i2);
+                }
+                terms.push_back(m.encode(vars,i) & m.encode(input_vars,x) & posts);
+            }
+        }
+        return disjunction(terms);
+    }
+};/* end of class definition */
+}/* end of namespace negotiation */
+#endif
@@ -0,0 +1,55 @@
+/* SymbolicSafetyGame.hpp
+ *
+ *  Date: 19/10/2026 */
+
+/** @file **/
+#ifndef SYMBOLICSAFETYGAME_HPP_
+#define SYMBOLICSAFETYGAME_HPP_
+
+#include <cstring>
+#include <unordered_set>
+
+#include "SymbolicMonitor.hpp"
+
+/** @namespace negotiation **/
+namespace negotiation {
+/**
+ *  @class SymbolicSafetyGame
+ *
+ *  @brief The safety games of SafetyGame solved on a SymbolicMonitor.
+ */
+class SymbolicSafetyGame: public SymbolicMonitor {
+public:
+    /*! Constructor
+     * \param[in] comp    The component
+     * \param[in] assume  A safety automaton representing the current assumptions
+     * \param[in] guarantee A safety automaton representing the current guarantees */
+    SymbolicSafetyGame(Component& comp, SafetyAutomaton& assume, SafetyAutomaton& guarantee) : SymbolicMonitor(comp, assume, guarantee) {}
+    /*! Solve safety game as the greatest fixed point of the safe states from where some input keeps all the posts in the fixed point.
+     *
+     * The semantics is the one of SafetyGame::solve_safety_game (in the non-local mode): the state reject_A is safe for sure winning only, reject_G is unsafe, and the dead-ends are losing.
+     * \param[in] component_safe_states         indices of safe states
+     * \param[in] str                           string specifying the sure/maybe winning condition
+     * \param[out] D                            winning state-input pairs: over (x,u) for sure winning, and over (x,u,w) for maybe winning */
+    Bdd solve_safety_game(const std::unordered_set<abs_type>& component_safe_states, const char* str="sure") {
+        if (strcmp(str,"sure") && strcmp(str,"maybe")) {
+            throw std::runtime_error("SymbolicSafetyGame: invalid input.");
+        }
+        bool sure=!strcmp(str,"sure");
+        Bdd safe=component_states(component_safe_states);
+        if (sure) {
+            safe|=reject_A_;
+        }
+        Bdd W=safe;
+        while (true) {
+            Bdd W_new=safe & cpre(W,sure);
+            if (W_new==W) {
+                break;
+            }
+            W=W_new;
+        }
+        return W & safe_inputs(W,sure);
+    }
+};/* end of class definition */
+}/* end of namespace negotiation */
+#endif